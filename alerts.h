@@ -0,0 +1,487 @@
+#pragma once
+#include "libquote.h"
+#include<algorithm>
+#include<chrono>
+#include<condition_variable>
+#include<cstdio>
+#include<deque>
+#include<fstream>
+#include<functional>
+#include<iomanip>
+#include<iostream>
+#include<memory>
+#include<mutex>
+#include<sstream>
+#include<sys/wait.h>
+#include<thread>
+#include<unordered_map>
+
+namespace quote {
+// Kinds of conditions a rule can watch for
+enum class AlertKind {
+    PriceAbove,     // price crosses up through a level
+    PriceBelow,     // price crosses down through a level
+    ChangeAbove,    // percent change from previous close rises through a level
+    ChangeBelow,    // percent change from previous close falls through a level
+    DayHighBreak,   // price trades above the previous day high
+    DayLowBreak,    // price trades below the previous day low
+    YearHighBreak,  // price trades above the previous 52-week high
+    YearLowBreak,   // price trades below the previous 52-week low
+    VolumeSpike     // volume traded since the last update is N times its running average
+};
+
+// A single rule loaded from the rules file
+struct AlertRule {
+    std::string symbol;
+    AlertKind kind = AlertKind::PriceAbove;
+    double threshold = 0.0;
+    std::string text; // Rule as written, used in alert messages
+    int line = 0;
+};
+
+// A triggered rule, ready for the output sinks
+struct Alert {
+    std::string time;
+    std::string symbol;
+    std::string rule;
+    double price = 0.0;
+    double changePercent = 0.0;
+
+    std::string toString() const {
+        std::stringstream ss;
+        ss << time << " " << symbol << " " << rule << " price=" << std::fixed << std::setprecision(2) << price
+           << " change=" << std::showpos << changePercent << std::noshowpos << "%";
+        return ss.str();
+    }
+};
+
+// Hands alerts to sinks on background threads so slow sinks never stall fetching.
+// Each sink has its own queue and thread, so a hook that hangs only holds up itself.
+class AlertDispatcher {
+private:
+    struct Lane {
+        std::function<void(const Alert&)> sink;
+        std::deque<Alert> queue;
+        size_t dropped = 0;
+        size_t discarded = 0;
+        bool stopping = false;
+        bool finished = false;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::condition_variable done;
+    };
+
+    // Lanes are shared with their threads so one left behind at shutdown stays valid
+    std::vector<std::shared_ptr<Lane>> lanes;
+    std::vector<std::thread> workers;
+    size_t capacity;
+    std::chrono::milliseconds shutdownGrace;
+
+    static void run(std::shared_ptr<Lane> lane) {
+        std::unique_lock<std::mutex> lock(lane->mutex);
+        while (true) {
+            lane->ready.wait(lock, [&lane] { return lane->stopping || !lane->queue.empty(); });
+            if (lane->stopping) break;
+
+            Alert alert = std::move(lane->queue.front());
+            lane->queue.pop_front();
+            lock.unlock();
+            lane->sink(alert);
+            lock.lock();
+        }
+        lane->finished = true;
+        lane->done.notify_all();
+    }
+
+public:
+    explicit AlertDispatcher(size_t capacity = 10000, double shutdownGraceSeconds = 2.0)
+        : capacity(capacity), shutdownGrace((long)(shutdownGraceSeconds * 1000)) {}
+
+    ~AlertDispatcher() {
+        stop();
+    }
+
+    void addSink(std::function<void(const Alert&)> sink) {
+        auto lane = std::make_shared<Lane>();
+        lane->sink = std::move(sink);
+        lanes.push_back(lane);
+    }
+
+    void start() {
+        for (auto& lane : lanes) {
+            workers.emplace_back(&AlertDispatcher::run, lane);
+        }
+    }
+
+    // Discards whatever is still queued and gives each sink until the grace
+    // period ends to finish its current alert; a sink still busy after that
+    // (a hung hook) is left behind so shutdown never waits on it
+    void stop() {
+        if (workers.empty()) return;
+        for (auto& lane : lanes) {
+            {
+                std::lock_guard<std::mutex> lock(lane->mutex);
+                lane->stopping = true;
+                lane->discarded += lane->queue.size();
+                lane->queue.clear();
+            }
+            lane->ready.notify_one();
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + shutdownGrace;
+        for (size_t i = 0; i < lanes.size(); i++) {
+            bool finished;
+            {
+                std::unique_lock<std::mutex> lock(lanes[i]->mutex);
+                finished = lanes[i]->done.wait_until(lock, deadline, [&] { return lanes[i]->finished; });
+            }
+            if (finished) {
+                workers[i].join();
+            } else {
+                std::cerr << "Error: Alert sink still busy at shutdown, not waiting for it" << std::endl;
+                workers[i].detach();
+            }
+        }
+        workers.clear();
+    }
+
+    // Never blocks on sinks; when a sink's queue is full its oldest alert is dropped
+    void publish(const Alert& alert) {
+        for (auto& lane : lanes) {
+            {
+                std::lock_guard<std::mutex> lock(lane->mutex);
+                if (lane->queue.size() >= capacity) {
+                    lane->queue.pop_front();
+                    lane->dropped++;
+                }
+                lane->queue.push_back(alert);
+            }
+            lane->ready.notify_one();
+        }
+    }
+
+    // Deliveries lost to a full queue, summed over sinks
+    size_t droppedCount() {
+        size_t total = 0;
+        for (auto& lane : lanes) {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            total += lane->dropped;
+        }
+        return total;
+    }
+
+    // Deliveries still queued when stop() was called, summed over sinks
+    size_t discardedCount() {
+        size_t total = 0;
+        for (auto& lane : lanes) {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            total += lane->discarded;
+        }
+        return total;
+    }
+
+    // Prints each alert on its own line
+    static std::function<void(const Alert&)> stdoutSink() {
+        return [](const Alert& alert) {
+            std::cout << "\033[1m\033[33mALERT\033[0m " << alert.toString() << std::endl;
+        };
+    }
+
+    // Appends each alert to a log file
+    static std::function<void(const Alert&)> fileSink(const std::string& path) {
+        auto out = std::make_shared<std::ofstream>(path, std::ios::app);
+        return [out](const Alert& alert) {
+            if (!*out) return;
+            *out << alert.toString() << std::endl;
+        };
+    }
+
+    // Runs a shell command per alert with the alert line on its stdin. Hooks may
+    // exit without reading it, so the caller must ignore SIGPIPE.
+    static std::function<void(const Alert&)> execSink(const std::string& command) {
+        return [command](const Alert& alert) {
+            FILE* pipe = popen(command.c_str(), "w");
+            if (!pipe) {
+                std::cerr << "Error: Failed to run alert hook: " << command << std::endl;
+                return;
+            }
+            std::string line = alert.toString() + "\n";
+            fwrite(line.data(), 1, line.size(), pipe);
+            int status = pclose(pipe);
+            if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "Error: Alert hook failed";
+                if (status != -1 && WIFEXITED(status)) {
+                    std::cerr << " with exit code " << WEXITSTATUS(status);
+                }
+                std::cerr << ": " << command << std::endl;
+            }
+        };
+    }
+};
+
+// Evaluates rules against stock updates, checking only the rules an update could trigger
+class AlertEngine {
+private:
+    typedef std::vector<std::pair<double, const AlertRule*>> Ladder;
+
+    // Rules for one symbol, with threshold rules kept sorted so a move from
+    // one value to another maps to a contiguous slice of each ladder
+    struct SymbolRules {
+        Ladder above;
+        Ladder below;
+        Ladder changeAbove;
+        Ladder changeBelow;
+        Ladder volumeSpike;
+        std::vector<const AlertRule*> dayHigh;
+        std::vector<const AlertRule*> dayLow;
+        std::vector<const AlertRule*> yearHigh;
+        std::vector<const AlertRule*> yearLow;
+
+        bool seeded = false;
+        double price = 0.0;
+        double changePercent = 0.0;
+        double dayHighLevel = 0.0;
+        double dayLowLevel = 0.0;
+        double yearHighLevel = 0.0;
+        double yearLowLevel = 0.0;
+        long volume = 0;
+        double averageVolumeDelta = 0.0;
+        bool dayHighBroken = false;
+        bool dayLowBroken = false;
+        bool yearHighBroken = false;
+        bool yearLowBroken = false;
+    };
+
+    std::vector<std::unique_ptr<AlertRule>> rules;
+    std::unordered_map<std::string, SymbolRules> index;
+    std::vector<std::string> symbolOrder;
+    size_t fired = 0;
+
+    static std::string upper(std::string value) {
+        for (char& c : value) c = std::toupper(static_cast<unsigned char>(c));
+        return value;
+    }
+
+    static bool parseKind(const std::string& word, AlertKind& kind, bool& needsThreshold) {
+        static const std::vector<std::pair<std::string, AlertKind>> kinds = {
+            {"above", AlertKind::PriceAbove},
+            {"below", AlertKind::PriceBelow},
+            {"change-above", AlertKind::ChangeAbove},
+            {"change-below", AlertKind::ChangeBelow},
+            {"day-high", AlertKind::DayHighBreak},
+            {"day-low", AlertKind::DayLowBreak},
+            {"52w-high", AlertKind::YearHighBreak},
+            {"52w-low", AlertKind::YearLowBreak},
+            {"volume-spike", AlertKind::VolumeSpike},
+        };
+        for (const auto& entry : kinds) {
+            if (entry.first == word) {
+                kind = entry.second;
+                needsThreshold = kind == AlertKind::PriceAbove || kind == AlertKind::PriceBelow ||
+                                 kind == AlertKind::ChangeAbove || kind == AlertKind::ChangeBelow ||
+                                 kind == AlertKind::VolumeSpike;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void indexRule(const AlertRule* rule) {
+        auto inserted = index.emplace(rule->symbol, SymbolRules());
+        if (inserted.second) {
+            symbolOrder.push_back(rule->symbol);
+        }
+        SymbolRules& entry = inserted.first->second;
+        switch (rule->kind) {
+            case AlertKind::PriceAbove: entry.above.emplace_back(rule->threshold, rule); break;
+            case AlertKind::PriceBelow: entry.below.emplace_back(rule->threshold, rule); break;
+            case AlertKind::ChangeAbove: entry.changeAbove.emplace_back(rule->threshold, rule); break;
+            case AlertKind::ChangeBelow: entry.changeBelow.emplace_back(rule->threshold, rule); break;
+            case AlertKind::VolumeSpike: entry.volumeSpike.emplace_back(rule->threshold, rule); break;
+            case AlertKind::DayHighBreak: entry.dayHigh.push_back(rule); break;
+            case AlertKind::DayLowBreak: entry.dayLow.push_back(rule); break;
+            case AlertKind::YearHighBreak: entry.yearHigh.push_back(rule); break;
+            case AlertKind::YearLowBreak: entry.yearLow.push_back(rule); break;
+        }
+    }
+
+    static void sortLadder(Ladder& ladder) {
+        std::sort(ladder.begin(), ladder.end(), [](const Ladder::value_type& a, const Ladder::value_type& b) {
+            return a.first < b.first;
+        });
+    }
+
+    static bool lessThreshold(const Ladder::value_type& entry, double value) {
+        return entry.first < value;
+    }
+
+    static bool lessValue(double value, const Ladder::value_type& entry) {
+        return value < entry.first;
+    }
+
+    // Rules with from < threshold <= to, i.e. levels crossed on the way up
+    template <typename Emit>
+    static void crossedUp(const Ladder& ladder, double from, double to, Emit emit) {
+        if (to <= from) return;
+        auto first = std::upper_bound(ladder.begin(), ladder.end(), from, lessValue);
+        auto last = std::upper_bound(first, ladder.end(), to, lessValue);
+        for (auto it = first; it != last; ++it) emit(it->second);
+    }
+
+    // Rules with to <= threshold < from, i.e. levels crossed on the way down
+    template <typename Emit>
+    static void crossedDown(const Ladder& ladder, double from, double to, Emit emit) {
+        if (to >= from) return;
+        auto first = std::lower_bound(ladder.begin(), ladder.end(), to, lessThreshold);
+        auto last = std::lower_bound(first, ladder.end(), from, lessThreshold);
+        for (auto it = first; it != last; ++it) emit(it->second);
+    }
+
+public:
+    // Loads rules from a file, one per line: SYMBOL CONDITION [VALUE]; '#' starts a comment
+    bool loadRules(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "Cannot open rules file: " + path;
+            return false;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            std::istringstream ss(line);
+            std::string symbol, condition, value, extra;
+            if (!(ss >> symbol)) continue;
+
+            auto rule = std::make_unique<AlertRule>();
+            rule->symbol = upper(symbol);
+            rule->line = lineNumber;
+            bool needsThreshold = false;
+            if (!(ss >> condition) || !parseKind(condition, rule->kind, needsThreshold)) {
+                error = path + ":" + std::to_string(lineNumber) + ": unknown condition '" + condition + "'";
+                return false;
+            }
+            if (!Client::isValidSymbol(rule->symbol)) {
+                error = path + ":" + std::to_string(lineNumber) + ": invalid symbol '" + symbol + "'";
+                return false;
+            }
+            if (needsThreshold) {
+                char* end = nullptr;
+                if (ss >> value) {
+                    rule->threshold = std::strtod(value.c_str(), &end);
+                }
+                if (value.empty() || *end != '\0') {
+                    error = path + ":" + std::to_string(lineNumber) + ": '" + condition + "' needs a numeric value";
+                    return false;
+                }
+            }
+            if (ss >> extra) {
+                error = path + ":" + std::to_string(lineNumber) + ": unexpected '" + extra + "'";
+                return false;
+            }
+
+            rule->text = condition + (needsThreshold ? " " + value : "");
+            indexRule(rule.get());
+            rules.push_back(std::move(rule));
+        }
+
+        for (auto& entry : index) {
+            sortLadder(entry.second.above);
+            sortLadder(entry.second.below);
+            sortLadder(entry.second.changeAbove);
+            sortLadder(entry.second.changeBelow);
+            sortLadder(entry.second.volumeSpike);
+        }
+        return true;
+    }
+
+    size_t ruleCount() const {
+        return rules.size();
+    }
+
+    size_t firedCount() const {
+        return fired;
+    }
+
+    // Symbols that have at least one rule, in file order
+    const std::vector<std::string>& symbols() const {
+        return symbolOrder;
+    }
+
+    // Checks one update; the first update for a symbol only sets the baseline,
+    // after that rules fire when their level is crossed
+    void evaluate(const std::string& symbol, const StockData& data, AlertDispatcher& dispatcher) {
+        auto found = index.find(upper(symbol));
+        if (found == index.end() || !data.hasData) return;
+        SymbolRules& entry = found->second;
+
+        double changePercent = data.previousClose > 0
+            ? (data.currentPrice - data.previousClose) / data.previousClose * 100.0
+            : 0.0;
+
+        if (entry.seeded) {
+            Alert base;
+            base.time = data.lastFetchTime;
+            base.symbol = found->first;
+            base.price = data.currentPrice;
+            base.changePercent = changePercent;
+            auto emit = [&](const AlertRule* rule) {
+                Alert alert = base;
+                alert.rule = rule->text;
+                dispatcher.publish(alert);
+                fired++;
+            };
+            auto emitAll = [&](const std::vector<const AlertRule*>& list) {
+                for (const AlertRule* rule : list) emit(rule);
+            };
+
+            crossedUp(entry.above, entry.price, data.currentPrice, emit);
+            crossedDown(entry.below, entry.price, data.currentPrice, emit);
+            crossedUp(entry.changeAbove, entry.changePercent, changePercent, emit);
+            crossedDown(entry.changeBelow, entry.changePercent, changePercent, emit);
+
+            // Range breaks fire once per session rather than on every new extreme
+            auto emitBreak = [&](bool broke, bool& latched, const std::vector<const AlertRule*>& list) {
+                if (broke && !latched) {
+                    latched = true;
+                    emitAll(list);
+                }
+            };
+            emitBreak(entry.dayHighLevel > 0 && data.currentPrice > entry.dayHighLevel, entry.dayHighBroken, entry.dayHigh);
+            emitBreak(entry.dayLowLevel > 0 && data.currentPrice < entry.dayLowLevel, entry.dayLowBroken, entry.dayLow);
+            emitBreak(entry.yearHighLevel > 0 && data.currentPrice > entry.yearHighLevel, entry.yearHighBroken, entry.yearHigh);
+            emitBreak(entry.yearLowLevel > 0 && data.currentPrice < entry.yearLowLevel, entry.yearLowBroken, entry.yearLow);
+
+            long delta = data.volume - entry.volume;
+            if (delta > 0 && entry.averageVolumeDelta > 0 && !entry.volumeSpike.empty()) {
+                double ratio = delta / entry.averageVolumeDelta;
+                auto last = std::upper_bound(entry.volumeSpike.begin(), entry.volumeSpike.end(), ratio, lessValue);
+                for (auto it = entry.volumeSpike.begin(); it != last; ++it) emit(it->second);
+            }
+            if (delta > 0) {
+                entry.averageVolumeDelta = entry.averageVolumeDelta > 0
+                    ? entry.averageVolumeDelta * 0.8 + delta * 0.2
+                    : delta;
+            } else if (delta < 0) {
+                // New session, volume counter reset
+                entry.averageVolumeDelta = 0.0;
+                entry.dayHighBroken = false;
+                entry.dayLowBroken = false;
+            }
+        }
+
+        entry.seeded = true;
+        entry.price = data.currentPrice;
+        entry.changePercent = changePercent;
+        entry.dayHighLevel = std::max(data.dayHigh, data.currentPrice);
+        entry.dayLowLevel = data.dayLow > 0 ? std::min(data.dayLow, data.currentPrice) : data.currentPrice;
+        entry.yearHighLevel = std::max(data.fiftyTwoWeekHigh, data.currentPrice);
+        entry.yearLowLevel = data.fiftyTwoWeekLow > 0 ? std::min(data.fiftyTwoWeekLow, data.currentPrice) : data.currentPrice;
+        entry.volume = data.volume;
+    }
+};
+}
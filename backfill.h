@@ -0,0 +1,419 @@
+#pragma once
+#include "libquote.h"
+#include<algorithm>
+#include<atomic>
+#include<cerrno>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<ctime>
+#include<fstream>
+#include<iomanip>
+#include<iostream>
+#include<limits>
+#include<mutex>
+#include<sstream>
+#include<sys/stat.h>
+#include<thread>
+#include<unistd.h>
+
+namespace quote {
+// Single OHLCV bar
+struct Bar {
+    long timestamp = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    long volume = 0;
+};
+
+// Settings for a historical backfill run
+struct BackfillOptions {
+    std::vector<std::string> symbols;
+    std::string exchange = "NASDAQ";
+    long from = 0;                  // Unix seconds, inclusive
+    long to = 0;                    // Unix seconds, exclusive
+    std::string interval = "1d";    // Yahoo bar size (1m, 5m, 1h, 1d, 1wk, ...)
+    std::string outputDir = ".";
+    int jobs = 4;                   // Concurrent transfers
+    double requestsPerSecond = 4.0; // Shared across all workers
+    int maxRetries = 3;
+    std::string statePath;          // Client state file, see ClientOptions
+};
+
+// Spaces out requests from all workers so we stay under the provider's rate limit
+class RateLimiter {
+private:
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point nextSlot = std::chrono::steady_clock::now();
+    std::chrono::duration<double> spacing;
+
+public:
+    explicit RateLimiter(double requestsPerSecond)
+        : spacing(requestsPerSecond > 0 ? 1.0 / requestsPerSecond : 0.0) {}
+
+    void acquire() {
+        std::chrono::steady_clock::time_point slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto now = std::chrono::steady_clock::now();
+            slot = std::max(now, nextSlot);
+            nextSlot = slot + std::chrono::duration_cast<std::chrono::steady_clock::duration>(spacing);
+        }
+        std::this_thread::sleep_until(slot);
+    }
+};
+
+// Pulls a date range of bars for many symbols and writes one columnar file per symbol
+class Backfill {
+private:
+    struct Chunk {
+        size_t symbolIndex;
+        long from;
+        long to;
+    };
+
+    BackfillOptions options;
+    std::vector<Chunk> chunks;
+    std::vector<std::vector<Bar>> results;
+    std::vector<std::mutex> resultLocks;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> failedChunks{0};
+    std::atomic<size_t> completedChunks{0};
+    std::atomic<bool> interrupted{false};
+    const volatile bool* keepRunning; // Cleared by the caller's signal handler, may be null
+    RateLimiter limiter;
+    Client client;
+    std::mutex logLock;
+
+    // Widest span the chart endpoint accepts in one request for each bar size
+    static long maxChunkSeconds(const std::string& interval) {
+        const long day = 86400;
+        if (interval == "1m") return 7 * day;
+        if (interval == "2m" || interval == "5m" || interval == "15m" ||
+            interval == "30m" || interval == "90m") return 30 * day;
+        if (interval == "60m" || interval == "1h") return 180 * day;
+        return 5 * 365 * day;
+    }
+
+    // How far back the provider keeps intraday bars at all
+    static long maxLookbackSeconds(const std::string& interval) {
+        const long day = 86400;
+        if (interval == "1m") return 30 * day;
+        if (interval == "2m" || interval == "5m" || interval == "15m" ||
+            interval == "30m" || interval == "90m") return 60 * day;
+        if (interval == "60m" || interval == "1h") return 730 * day;
+        return 0;
+    }
+
+    static ClientOptions clientOptions(const BackfillOptions& options) {
+        ClientOptions clientOptions;
+        clientOptions.maxConnections = std::max(1, options.jobs);
+        clientOptions.statePath = options.statePath;
+        return clientOptions;
+    }
+
+    void log(const std::string& message) {
+        std::lock_guard<std::mutex> lock(logLock);
+        std::cerr << message << std::endl;
+    }
+
+    // Extracts a numeric JSON array, keeping nulls as NaN so columns stay aligned
+    static std::vector<double> extractNumberArray(const std::string& json, const std::string& key, size_t from) {
+        std::vector<double> values;
+        std::string searchKey = "\"" + key + "\":[";
+        size_t pos = json.find(searchKey, from);
+        if (pos == std::string::npos) return values;
+        pos += searchKey.length();
+        size_t end = json.find(']', pos);
+        if (end == std::string::npos) return values;
+
+        const char* p = json.c_str() + pos;
+        const char* stop = json.c_str() + end;
+        while (p < stop) {
+            while (p < stop && (*p == ',' || *p == ' ')) p++;
+            if (p >= stop) break;
+            if (*p == 'n') {
+                values.push_back(std::numeric_limits<double>::quiet_NaN());
+                p += 4;
+            } else {
+                char* next = nullptr;
+                values.push_back(std::strtod(p, &next));
+                if (next == p) break;
+                p = next;
+            }
+        }
+        return values;
+    }
+
+    static bool parseBars(const std::string& json, std::vector<Bar>& bars) {
+        if (json.find("\"result\":null") != std::string::npos) {
+            return false;
+        }
+
+        std::vector<double> timestamps = extractNumberArray(json, "timestamp", 0);
+        if (timestamps.empty()) return true; // No trading in this window
+
+        size_t quotePos = json.find("\"quote\":[", json.find("\"indicators\":"));
+        if (quotePos == std::string::npos) return false;
+
+        std::vector<double> open = extractNumberArray(json, "open", quotePos);
+        std::vector<double> high = extractNumberArray(json, "high", quotePos);
+        std::vector<double> low = extractNumberArray(json, "low", quotePos);
+        std::vector<double> close = extractNumberArray(json, "close", quotePos);
+        std::vector<double> volume = extractNumberArray(json, "volume", quotePos);
+
+        for (size_t i = 0; i < timestamps.size() && i < close.size(); i++) {
+            if (std::isnan(close[i])) continue;
+            Bar bar;
+            bar.timestamp = (long)timestamps[i];
+            bar.close = close[i];
+            bar.open = (i < open.size() && !std::isnan(open[i])) ? open[i] : close[i];
+            bar.high = (i < high.size() && !std::isnan(high[i])) ? high[i] : close[i];
+            bar.low = (i < low.size() && !std::isnan(low[i])) ? low[i] : close[i];
+            bar.volume = (i < volume.size() && !std::isnan(volume[i])) ? (long)volume[i] : 0;
+            bars.push_back(bar);
+        }
+        return true;
+    }
+
+    // Only throttling and server-side failures are worth another attempt
+    static bool isRetryable(long responseCode) {
+        return responseCode == 0 || responseCode == 429 || responseCode >= 500;
+    }
+
+    bool stopRequested() {
+        if (keepRunning && !*keepRunning) interrupted = true;
+        return interrupted;
+    }
+
+    bool fetchChunk(const Chunk& chunk, std::vector<Bar>& bars, std::string& error) {
+        const std::string& symbol = options.symbols[chunk.symbolIndex];
+        std::string url = Client::chartUrl(Client::buildFullSymbol(symbol, options.exchange),
+                                           "period1=" + std::to_string(chunk.from) +
+                                           "&period2=" + std::to_string(chunk.to) +
+                                           "&interval=" + options.interval +
+                                           "&includePrePost=false");
+
+        for (int attempt = 0; attempt <= options.maxRetries; attempt++) {
+            if (attempt > 0) {
+                if (stopRequested()) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(500 << (attempt - 1)));
+            }
+            limiter.acquire();
+
+            Response response = client.get(url).get();
+            if (response.error) {
+                error = response.error.message;
+                if (response.error.code == ErrorCode::Http && !isRetryable(response.status)) return false;
+                if (response.error.code == ErrorCode::Cancelled) return false;
+                continue;
+            }
+
+            bars.clear();
+            if (parseBars(response.body, bars)) return true;
+            error = "API returned an error.";
+        }
+        return false;
+    }
+
+    void worker() {
+        std::vector<Bar> bars;
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            if (stopRequested()) break;
+            const Chunk& chunk = chunks[i];
+            std::string error;
+            if (fetchChunk(chunk, bars, error)) {
+                std::lock_guard<std::mutex> lock(resultLocks[chunk.symbolIndex]);
+                auto& out = results[chunk.symbolIndex];
+                out.insert(out.end(), bars.begin(), bars.end());
+                completedChunks++;
+            } else if (stopRequested()) {
+                break;
+            } else {
+                failedChunks++;
+                log("Error: " + options.symbols[chunk.symbolIndex] + " chunk " +
+                    formatDate(chunk.from) + ".." + formatDate(chunk.to) + ": " + error);
+            }
+        }
+    }
+
+    // Chunks overlap at their edges, so keep one bar per timestamp
+    static void sortAndDeduplicate(std::vector<Bar>& bars) {
+        std::stable_sort(bars.begin(), bars.end(), [](const Bar& a, const Bar& b) {
+            return a.timestamp < b.timestamp;
+        });
+        auto last = std::unique(bars.rbegin(), bars.rend(), [](const Bar& a, const Bar& b) {
+            return a.timestamp == b.timestamp;
+        });
+        bars.erase(bars.begin(), last.base());
+    }
+
+    template <typename T>
+    static void writeColumn(std::ofstream& out, const std::vector<Bar>& bars, T Bar::*field) {
+        std::vector<T> column;
+        column.reserve(bars.size());
+        for (const Bar& bar : bars) column.push_back(bar.*field);
+        out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+    }
+
+    static void writeString(std::ofstream& out, const std::string& value) {
+        uint32_t length = value.size();
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(value.data(), length);
+    }
+
+    // Layout: "QCOL", u32 version, u64 rows, symbol, interval, then one contiguous
+    // column each for timestamp (i64), open, high, low, close (f64) and volume (i64)
+    bool writeColumnar(const std::string& path, const std::string& symbol, const std::vector<Bar>& bars) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        const uint32_t version = 1;
+        const uint64_t rows = bars.size();
+        out.write("QCOL", 4);
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        writeString(out, symbol);
+        writeString(out, options.interval);
+
+        std::vector<int64_t> timestamps;
+        std::vector<int64_t> volumes;
+        timestamps.reserve(bars.size());
+        volumes.reserve(bars.size());
+        for (const Bar& bar : bars) {
+            timestamps.push_back(bar.timestamp);
+            volumes.push_back(bar.volume);
+        }
+        out.write(reinterpret_cast<const char*>(timestamps.data()), timestamps.size() * sizeof(int64_t));
+        writeColumn(out, bars, &Bar::open);
+        writeColumn(out, bars, &Bar::high);
+        writeColumn(out, bars, &Bar::low);
+        writeColumn(out, bars, &Bar::close);
+        out.write(reinterpret_cast<const char*>(volumes.data()), volumes.size() * sizeof(int64_t));
+        return (bool)out;
+    }
+
+public:
+    // keepRunning is polled between chunks and retries; once it goes false the
+    // workers stop and run() writes whatever was collected
+    Backfill(const BackfillOptions& options, const volatile bool* keepRunning = nullptr)
+        : options(options),
+          results(options.symbols.size()),
+          resultLocks(options.symbols.size()),
+          keepRunning(keepRunning),
+          limiter(options.requestsPerSecond),
+          client(clientOptions(options)) {}
+
+    // Parses YYYY-MM-DD as a UTC date, returns -1 on bad input
+    static long parseDate(const std::string& date) {
+        std::tm tm = {};
+        std::istringstream ss(date);
+        ss >> std::get_time(&tm, "%Y-%m-%d");
+        if (ss.fail()) return -1;
+        return (long)timegm(&tm);
+    }
+
+    static std::string formatDate(long timestamp) {
+        time_t t = timestamp;
+        std::tm tm = {};
+        gmtime_r(&t, &tm);
+        std::stringstream ss;
+        ss << std::put_time(&tm, "%Y-%m-%d");
+        return ss.str();
+    }
+
+    // Creates the output directory and its parents if needed, then checks it is writable
+    static bool prepareOutputDir(const std::string& dir) {
+        for (size_t pos = dir.find('/', 1); ; pos = dir.find('/', pos + 1)) {
+            std::string part = dir.substr(0, pos);
+            if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+            if (pos == std::string::npos) break;
+        }
+        return access(dir.c_str(), W_OK) == 0;
+    }
+
+    // Runs the backfill, returns false if any chunk or file could not be completed
+    bool run() {
+        // Fail before downloading anything rather than after
+        if (!prepareOutputDir(options.outputDir)) {
+            log("Error: Cannot write to output directory: " + options.outputDir);
+            return false;
+        }
+
+        long now = (long)std::time(nullptr);
+        if (options.to <= 0 || options.to > now) options.to = now;
+
+        // Keep a day clear of the provider's window: chunks go out later than now
+        // was taken, and a start even slightly too old is rejected with a 422
+        long lookback = maxLookbackSeconds(options.interval);
+        const long margin = 86400;
+        if (lookback > 0 && options.from < now - lookback + margin) {
+            options.from = now - lookback + margin;
+            log("Warning: " + options.interval + " bars only go back " + std::to_string(lookback / 86400) +
+                " days, clamping start date to " + formatDate(options.from) + " (one day inside the limit)");
+        }
+        if (options.from >= options.to) {
+            log("Error: Empty date range");
+            return false;
+        }
+
+        long span = maxChunkSeconds(options.interval);
+        for (size_t s = 0; s < options.symbols.size(); s++) {
+            for (long start = options.from; start < options.to; start += span) {
+                chunks.push_back({s, start, std::min(start + span, options.to)});
+            }
+        }
+
+        int jobs = std::max(1, std::min<int>(options.jobs, chunks.size()));
+        std::cout << "Backfilling " << options.symbols.size() << " symbol(s), "
+                  << formatDate(options.from) << " to " << formatDate(options.to - 1)
+                  << " at " << options.interval << " in " << chunks.size()
+                  << " chunk(s) using " << jobs << " connection(s)" << std::endl;
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < jobs; i++) {
+            workers.emplace_back(&Backfill::worker, this);
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+
+        if (interrupted) {
+            log("Interrupted after " + std::to_string(completedChunks) + " of " +
+                std::to_string(chunks.size()) + " chunk(s), writing what was collected");
+        }
+
+        bool ok = failedChunks == 0 && !interrupted;
+        for (size_t s = 0; s < options.symbols.size(); s++) {
+            std::vector<Bar>& bars = results[s];
+            sortAndDeduplicate(bars);
+
+            const std::string& symbol = options.symbols[s];
+            if (bars.empty()) {
+                std::cout << "  " << symbol << ": no bars" << std::endl;
+                continue;
+            }
+            std::string path = options.outputDir + "/" + Client::buildFullSymbol(symbol, options.exchange) +
+                               "_" + options.interval + ".qcol";
+            if (!writeColumnar(path, symbol, bars)) {
+                log("Error: Failed to write " + path);
+                ok = false;
+                continue;
+            }
+            std::cout << "  " << symbol << ": " << bars.size() << " bars -> " << path << std::endl;
+        }
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+        std::cout << "Backfill finished in " << std::fixed << std::setprecision(1) << elapsed.count() << "s";
+        if (failedChunks > 0) {
+            std::cout << " (" << failedChunks << " chunk(s) failed)";
+        }
+        std::cout << std::endl;
+        return ok;
+    }
+};
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include "libquote.h"
+#include<algorithm>
+#include<chrono>
+#include<condition_variable>
+#include<ctime>
+#include<iomanip>
+#include<iostream>
+#include<memory>
+#include<mutex>
+#include<sstream>
+#include<string>
+#include<sys/ioctl.h>
+#include<unistd.h>
+#include<vector>
+
+namespace quote {
+// Dense watch view: one single-line cell per symbol, laid out to the terminal
+// and repainted only where the data changed
+class Grid {
+private:
+    static constexpr int symbolWidth = 9;
+    static constexpr int priceWidth = 11;
+    static constexpr int changeWidth = 9;
+    static constexpr int sparkWidth = 12;
+    static constexpr int gapWidth = 2;
+    static constexpr int cellWidth = symbolWidth + priceWidth + changeWidth + sparkWidth;
+
+    struct Cell {
+        std::string symbol;
+        uint64_t fingerprint = 0;
+        bool hasData = false;
+        bool failed = false;
+        bool dirty = true;
+        bool pending = false; // A fetch is in flight, don't start another
+        double price = 0.0;
+        double changePercent = 0.0;
+        std::string spark;
+    };
+
+    // Results handed over by the engine thread. Shared with the callbacks so a
+    // result that misses its tick still has somewhere to land.
+    struct Inbox {
+        std::mutex mutex;
+        std::condition_variable arrived;
+        std::vector<std::pair<size_t, QuoteResult>> results;
+    };
+
+    std::vector<Cell> cells;
+    std::shared_ptr<Inbox> inbox = std::make_shared<Inbox>();
+    size_t inFlight = 0;
+    std::string exchange;
+    Client& client;
+    std::chrono::microseconds frameBudget;
+
+    int termRows = 0;
+    int termCols = 0;
+    int columns = 1;
+    int visibleRows = 0;
+    size_t nextDirty = 0; // Where the next frame resumes if the last one ran out of budget
+    long skippedTicks = 0;
+    double lastFrameMs = 0.0;
+
+    static void terminalSize(int& rows, int& cols) {
+        struct winsize ws;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+            rows = ws.ws_row;
+            cols = ws.ws_col;
+        } else {
+            rows = 24;
+            cols = 80;
+        }
+    }
+
+    // Buckets the series into width columns and maps each to one of eight bar heights
+    static std::string sparkline(const std::vector<double>& prices, int width) {
+        static const char* levels[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+        if (prices.empty()) return std::string(width, ' ');
+
+        int points = std::min<int>(width, prices.size());
+        std::vector<double> buckets(points);
+        for (int i = 0; i < points; i++) {
+            size_t index = ((i + 1) * prices.size()) / points - 1;
+            buckets[i] = prices[index];
+        }
+
+        double minPrice = *std::min_element(buckets.begin(), buckets.end());
+        double maxPrice = *std::max_element(buckets.begin(), buckets.end());
+        double range = maxPrice - minPrice;
+
+        std::string spark;
+        for (double price : buckets) {
+            int level = range > 0 ? (int)((price - minPrice) / range * 7.0 + 0.5) : 3;
+            spark += levels[std::max(0, std::min(7, level))];
+        }
+        spark += std::string(width - points, ' ');
+        return spark;
+    }
+
+    bool layout() {
+        int rows, cols;
+        terminalSize(rows, cols);
+        if (rows == termRows && cols == termCols) return false;
+
+        termRows = rows;
+        termCols = cols;
+        columns = std::max(1, (cols + gapWidth) / (cellWidth + gapWidth));
+        visibleRows = std::max(1, rows - 1);
+        for (Cell& cell : cells) {
+            cell.dirty = true;
+        }
+        return true;
+    }
+
+    void apply(Cell& cell, QuoteResult& result) {
+        if (result.error) {
+            if (!cell.failed) cell.dirty = true;
+            cell.failed = true;
+            return;
+        }
+        if (result.unchanged) {
+            // Same data as before, but the fetch worked, so drop the error marker
+            if (cell.failed) cell.dirty = true;
+            cell.failed = false;
+            skippedTicks++;
+            return;
+        }
+
+        const StockData& data = result.data;
+        cell.fingerprint = result.fingerprint;
+        cell.failed = false;
+        cell.hasData = data.hasData;
+        cell.price = data.currentPrice;
+        cell.changePercent = data.previousClose > 0
+            ? (data.currentPrice - data.previousClose) / data.previousClose * 100.0
+            : 0.0;
+        cell.spark = sparkline(data.prices, sparkWidth - 1);
+        cell.dirty = true;
+    }
+
+    static void renderCell(std::ostream& out, const Cell& cell) {
+        std::string green = "\033[32m";
+        std::string red = "\033[31m";
+        std::string dim = "\033[2m";
+        std::string reset = "\033[0m";
+        std::string bold = "\033[1m";
+
+        out << bold << std::left << std::setw(symbolWidth) << cell.symbol.substr(0, symbolWidth - 1) << reset;
+        if (!cell.hasData) {
+            out << dim << std::left << std::setw(cellWidth - symbolWidth) << (cell.failed ? "error" : "...") << reset;
+            return;
+        }
+
+        std::string color = cell.changePercent >= 0 ? green : red;
+        out << std::right << std::fixed << std::setprecision(2) << std::setw(priceWidth - 1) << cell.price << " "
+            << color << std::showpos << std::setw(changeWidth - 2) << cell.changePercent << std::noshowpos << "% "
+            << cell.spark << reset << dim << (cell.failed ? "!" : " ") << reset;
+    }
+
+    void renderHeader(std::ostream& out, double refreshInterval, size_t hidden) const {
+        auto now = std::chrono::system_clock::now();
+        auto time_t = std::chrono::system_clock::to_time_t(now);
+        std::ostringstream header;
+        header << "Every " << refreshInterval << "s: " << cells.size() << " symbols";
+        if (hidden > 0) {
+            header << " (" << hidden << " off-screen)";
+        }
+        header << "    " << std::put_time(std::localtime(&time_t), "%a %b %d %H:%M:%S %Y")
+               << "    frame " << std::fixed << std::setprecision(1) << lastFrameMs << "ms";
+
+        // Never let the header wrap into the first row of cells
+        out << "\033[1;1H\033[2K" << header.str().substr(0, std::max(0, termCols - 1));
+    }
+
+public:
+    Grid(const std::vector<std::string>& symbols, const std::string& exchange, Client& client,
+         double frameBudgetMs = 15.0)
+        : exchange(exchange), client(client),
+          frameBudget((long)(frameBudgetMs * 1000)) {
+        for (const auto& symbol : symbols) {
+            Cell cell;
+            cell.symbol = symbol;
+            cells.push_back(cell);
+        }
+    }
+
+    // Fetches every symbol through the shared client and marks changed cells dirty.
+    // Waits at most timeoutSeconds; symbols still in flight are applied on a
+    // later tick, so one stalled symbol can't freeze the grid.
+    void refresh(double timeoutSeconds) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(timeoutSeconds));
+        for (size_t i = 0; i < cells.size(); i++) {
+            Cell& cell = cells[i];
+            if (cell.pending) continue;
+            cell.pending = true;
+            inFlight++;
+
+            std::shared_ptr<Inbox> box = inbox;
+            client.fetchQuote(cell.symbol, exchange, cell.fingerprint, [box, i](QuoteResult result) {
+                {
+                    std::lock_guard<std::mutex> lock(box->mutex);
+                    box->results.emplace_back(i, std::move(result));
+                }
+                box->arrived.notify_one();
+            });
+        }
+
+        std::vector<std::pair<size_t, QuoteResult>> ready;
+        {
+            std::unique_lock<std::mutex> lock(inbox->mutex);
+            inbox->arrived.wait_until(lock, deadline, [this] { return inbox->results.size() >= inFlight; });
+            ready.swap(inbox->results);
+        }
+        for (auto& entry : ready) {
+            Cell& cell = cells[entry.first];
+            cell.pending = false;
+            inFlight--;
+            apply(cell, entry.second);
+        }
+    }
+
+    // Repaints dirty cells until the frame budget runs out; the rest wait for the next frame
+    void render(double refreshInterval) {
+        auto start = std::chrono::steady_clock::now();
+        std::ostringstream frame;
+        if (layout()) {
+            frame << "\033[2J";
+            nextDirty = 0;
+        }
+
+        size_t capacity = (size_t)columns * visibleRows;
+        size_t shown = std::min(capacity, cells.size());
+        size_t visited = 0;
+        for (; visited < shown; visited++) {
+            size_t i = (nextDirty + visited) % shown;
+            Cell& cell = cells[i];
+            if (!cell.dirty) continue;
+
+            int row = 2 + (int)(i / columns);
+            int col = 1 + (int)(i % columns) * (cellWidth + gapWidth);
+            frame << "\033[" << row << ";" << col << "H";
+            renderCell(frame, cell);
+            cell.dirty = false;
+
+            if (std::chrono::steady_clock::now() - start >= frameBudget) {
+                visited++;
+                break;
+            }
+        }
+        nextDirty = shown > 0 ? (nextDirty + visited) % shown : 0;
+
+        renderHeader(frame, refreshInterval, cells.size() - shown);
+        std::cout << frame.str() << std::flush;
+
+        lastFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    long skipped() const {
+        return skippedTicks;
+    }
+};
+}
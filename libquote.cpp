@@ -0,0 +1,919 @@
+#include "libquote.h"
+#include<curl/curl.h>
+#include<algorithm>
+#include<atomic>
+#include<cerrno>
+#include<chrono>
+#include<condition_variable>
+#include<cstdio>
+#include<ctime>
+#include<deque>
+#include<fcntl.h>
+#include<fstream>
+#include<iomanip>
+#include<map>
+#include<mutex>
+#include<sstream>
+#include<sys/stat.h>
+#include<thread>
+#include<unistd.h>
+
+namespace quote {
+namespace {
+// curl_global_init/cleanup are not thread-safe on older libcurl, so clients share a refcount
+std::mutex globalInitLock;
+int globalInitCount = 0;
+
+void globalInit() {
+    std::lock_guard<std::mutex> lock(globalInitLock);
+    if (globalInitCount++ == 0) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+    }
+}
+
+void globalCleanup() {
+    std::lock_guard<std::mutex> lock(globalInitLock);
+    if (--globalInitCount == 0) {
+        curl_global_cleanup();
+    }
+}
+
+std::string currentTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm = {};
+    localtime_r(&time_t, &tm);
+    std::stringstream ss;
+    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+// Lets TLS session export be compiled out on libcurl builds that predate it
+#if LIBCURL_VERSION_NUM >= 0x080c00
+#define QUOTE_HAVE_SSLS_EXPORT 1
+#endif
+
+std::string toHex(const unsigned char* data, size_t length) {
+    static const char* digits = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(length * 2);
+    for (size_t i = 0; i < length; i++) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool fromHex(const std::string& hex, std::string& out) {
+    if (hex.size() % 2 != 0) return false;
+    out.clear();
+    out.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        char* end = nullptr;
+        std::string pair = hex.substr(i, 2);
+        long value = std::strtol(pair.c_str(), &end, 16);
+        if (*end != '\0') return false;
+        out += (char)value;
+    }
+    return true;
+}
+
+// "host:port" key of an http(s) URL, the form CURLOPT_RESOLVE expects
+std::string hostPortOf(const std::string& url) {
+    size_t start = url.find("://");
+    std::string port = url.compare(0, start, "http") == 0 ? "80" : "443";
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of("/?", start);
+    std::string host = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    if (host.find(':') == std::string::npos) host += ":" + port;
+    return host;
+}
+
+// Creates every missing directory above path
+void makeParentDirs(const std::string& path) {
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+        std::string dir = path.substr(0, pos);
+        if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return;
+    }
+}
+
+// Resolved addresses and TLS sessions carried between processes, so a short-lived
+// invocation can skip DNS and resume TLS instead of doing a full handshake
+class ClientState {
+private:
+    struct Address {
+        std::string address;
+        long expires = 0;
+    };
+
+    struct Session {
+        std::string key;
+        std::string hmac;
+        std::string data;
+        long expires = 0;
+    };
+
+    std::string path;
+    long dnsSeconds;
+    std::map<std::string, Address> addresses; // "host:port" -> address
+    std::vector<Session> sessions;
+    std::vector<std::string> evicted;         // "host:port" entries to drop from curl's DNS cache
+    bool dirty = false;
+
+public:
+    ClientState(const std::string& path, long dnsSeconds) : path(path), dnsSeconds(dnsSeconds) {
+        if (path.empty()) return;
+        std::ifstream in(path);
+        long now = (long)std::time(nullptr);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ss(line);
+            std::string kind;
+            ss >> kind;
+            if (kind == "dns") {
+                std::string hostPort;
+                Address entry;
+                if (ss >> hostPort >> entry.address >> entry.expires && entry.expires > now) {
+                    addresses[hostPort] = entry;
+                }
+            } else if (kind == "tls") {
+                std::string key, hmac, data;
+                Session session;
+                if (ss >> key >> hmac >> data >> session.expires && session.expires > now &&
+                    fromHex(key, session.key) && fromHex(hmac, session.hmac) && fromHex(data, session.data)) {
+                    sessions.push_back(session);
+                }
+            }
+        }
+    }
+
+    bool enabled() const {
+        return !path.empty();
+    }
+
+    // CURLOPT_RESOLVE entry for hostPort: the pinned address, or a removal of
+    // the stale one so curl resolves it again; caller frees the list
+    curl_slist* resolveFor(const std::string& hostPort) const {
+        auto found = addresses.find(hostPort);
+        if (found != addresses.end()) {
+            return curl_slist_append(nullptr, (hostPort + ":" + found->second.address).c_str());
+        }
+        if (std::find(evicted.begin(), evicted.end(), hostPort) != evicted.end()) {
+            return curl_slist_append(nullptr, ("-" + hostPort).c_str());
+        }
+        return nullptr;
+    }
+
+    bool isPinned(const std::string& hostPort) const {
+        return addresses.count(hostPort) > 0;
+    }
+
+    // Records the address a transfer actually connected to
+    void remember(const std::string& hostPort, std::string address) {
+        if (!enabled() || address.empty()) return;
+        if (address.find(':') != std::string::npos) address = "[" + address + "]";
+        auto found = addresses.find(hostPort);
+        if (found != addresses.end() && found->second.address == address) return;
+        addresses[hostPort] = {address, (long)std::time(nullptr) + dnsSeconds};
+        evicted.erase(std::remove(evicted.begin(), evicted.end(), hostPort), evicted.end());
+        dirty = true;
+    }
+
+    // Drops an address that stopped working so the next attempt resolves it again
+    void forget(const std::string& hostPort) {
+        if (addresses.erase(hostPort) > 0) {
+            evicted.push_back(hostPort);
+            dirty = true;
+        }
+    }
+
+#ifdef QUOTE_HAVE_SSLS_EXPORT
+    void importSessions(CURL* easy) const {
+        for (const Session& session : sessions) {
+            curl_easy_ssls_import(easy, session.key.c_str(),
+                                  (const unsigned char*)session.hmac.data(), session.hmac.size(),
+                                  (const unsigned char*)session.data.data(), session.data.size());
+        }
+    }
+
+    static CURLcode exportSession(CURL*, void* userptr, const char* key,
+                                  const unsigned char* hmac, size_t hmacLength,
+                                  const unsigned char* data, size_t dataLength,
+                                  curl_off_t validUntil, int, const char*, size_t) {
+        ClientState* state = static_cast<ClientState*>(userptr);
+        if (!key || !hmac || !data) return CURLE_OK;
+        Session session;
+        session.key = key;
+        session.hmac.assign((const char*)hmac, hmacLength);
+        session.data.assign((const char*)data, dataLength);
+        session.expires = (long)validUntil;
+        state->sessions.push_back(session);
+        state->dirty = true;
+        return CURLE_OK;
+    }
+
+    void exportSessions(CURL* easy) {
+        std::vector<Session> previous;
+        previous.swap(sessions);
+        if (curl_easy_ssls_export(easy, exportSession, this) != CURLE_OK) {
+            sessions.swap(previous);
+        }
+    }
+#else
+    void importSessions(CURL*) const {}
+    void exportSessions(CURL*) {}
+#endif
+
+    // Writes to a temporary file and renames it, so concurrent runs never see a torn file.
+    // The file holds TLS resumption secrets, so it is created owner-only whatever the umask.
+    void save() {
+        if (!enabled() || !dirty) return;
+        makeParentDirs(path);
+
+        std::ostringstream out;
+        out << "# quote client state v1\n";
+        for (const auto& entry : addresses) {
+            out << "dns " << entry.first << " " << entry.second.address << " " << entry.second.expires << "\n";
+        }
+        for (const Session& session : sessions) {
+            out << "tls " << toHex((const unsigned char*)session.key.data(), session.key.size())
+                << " " << toHex((const unsigned char*)session.hmac.data(), session.hmac.size())
+                << " " << toHex((const unsigned char*)session.data.data(), session.data.size())
+                << " " << session.expires << "\n";
+        }
+        std::string contents = out.str();
+
+        std::string temp = path + "." + std::to_string(getpid());
+        unlink(temp.c_str());
+        int fd = open(temp.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+        if (fd < 0) return;
+        bool written = write(fd, contents.data(), contents.size()) == (ssize_t)contents.size();
+        if (close(fd) != 0 || !written || std::rename(temp.c_str(), path.c_str()) != 0) {
+            unlink(temp.c_str());
+            return;
+        }
+        dirty = false;
+    }
+};
+
+// Helper function to extract string values from meta section
+static std::string extractStringFromMeta(const std::string& json, const std::string& key) {
+    size_t metaPos = json.find("\"meta\":");
+    if (metaPos == std::string::npos) return "";
+    
+    size_t metaEnd = json.find("\"timestamp\":", metaPos);
+    if (metaEnd == std::string::npos) metaEnd = json.size();
+    
+    std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
+    
+    std::string searchKey = "\"" + key + "\":\"";
+    size_t pos = metaSection.find(searchKey);
+    if (pos != std::string::npos) {
+        pos += searchKey.length();
+        size_t end = metaSection.find("\"", pos);
+        if (end != std::string::npos) {
+            return metaSection.substr(pos, end - pos);
+        }
+    }
+    return "";
+}
+
+// Helper function to extract double values from meta section
+static double extractDoubleFromMeta(const std::string& json, const std::string& key) {
+    size_t metaPos = json.find("\"meta\":");
+    if (metaPos == std::string::npos) return 0.0;
+    
+    size_t metaEnd = json.find("\"timestamp\":", metaPos);
+    if (metaEnd == std::string::npos) metaEnd = json.size();
+    
+    std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
+    
+    std::string searchKey = "\"" + key + "\":";
+    size_t pos = metaSection.find(searchKey);
+    if (pos != std::string::npos) {
+        pos += searchKey.length();
+        size_t end = metaSection.find_first_of(",}", pos);
+        if (end != std::string::npos) {
+            std::string valueStr = metaSection.substr(pos, end - pos);
+            try {
+                return std::stod(valueStr);
+            } catch (...) {
+                return 0.0;
+            }
+        }
+    }
+    return 0.0;
+}
+
+// Helper function to extract long values from meta section
+static long extractLongFromMeta(const std::string& json, const std::string& key) {
+    size_t metaPos = json.find("\"meta\":");
+    if (metaPos == std::string::npos) return 0;
+    
+    size_t metaEnd = json.find("\"timestamp\":", metaPos);
+    if (metaEnd == std::string::npos) metaEnd = json.size();
+    
+    std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
+    
+    std::string searchKey = "\"" + key + "\":";
+    size_t pos = metaSection.find(searchKey);
+    if (pos != std::string::npos) {
+        pos += searchKey.length();
+        size_t end = metaSection.find_first_of(",}", pos);
+        if (end != std::string::npos) {
+            std::string valueStr = metaSection.substr(pos, end - pos);
+            try {
+                return std::stol(valueStr);
+            } catch (...) {
+                return 0;
+            }
+        }
+    }
+    return 0;
+}
+
+static void extractPriceArrayFromIndicators(const std::string& json, std::vector<double>& prices, std::vector<long>& timestamps) {
+    // First extract timestamps from the main data section
+    size_t timestampPos = json.find("\"timestamp\":[");
+    if (timestampPos != std::string::npos) {
+        timestampPos += 13; // length of "\"timestamp\":["
+        size_t endPos = json.find("]", timestampPos);
+        if (endPos != std::string::npos) {
+            std::string timestampStr = json.substr(timestampPos, endPos - timestampPos);
+            std::stringstream ss(timestampStr);
+            std::string timestamp;
+            
+            while (std::getline(ss, timestamp, ',')) {
+                try {
+                    // Remove any whitespace
+                    timestamp.erase(0, timestamp.find_first_not_of(" \t\n\r"));
+                    timestamp.erase(timestamp.find_last_not_of(" \t\n\r") + 1);
+                    
+                    if (!timestamp.empty() && timestamp != "null") {
+                        timestamps.push_back(std::stol(timestamp));
+                    }
+                } catch (...) {
+                    // Skip invalid values
+                }
+            }
+        }
+    }
+    
+    // Look for the indicators section with quote data
+    size_t indicatorsPos = json.find("\"indicators\":");
+    if (indicatorsPos == std::string::npos) return;
+    
+    size_t quotePos = json.find("\"quote\":[", indicatorsPos);
+    if (quotePos == std::string::npos) return;
+    
+    size_t closePos = json.find("\"close\":[", quotePos);
+    if (closePos != std::string::npos) {
+        closePos += 9; // length of "\"close\":["
+        size_t endPos = json.find("]", closePos);
+        if (endPos != std::string::npos) {
+            std::string priceStr = json.substr(closePos, endPos - closePos);
+            std::stringstream ss(priceStr);
+            std::string price;
+            
+            while (std::getline(ss, price, ',')) {
+                try {
+                    // Remove any whitespace
+                    price.erase(0, price.find_first_not_of(" \t\n\r"));
+                    price.erase(price.find_last_not_of(" \t\n\r") + 1);
+                    
+                    if (!price.empty() && price != "null") {
+                        prices.push_back(std::stod(price));
+                    }
+                } catch (...) {
+                    // Skip invalid values - keep arrays aligned
+                    if (!timestamps.empty() && timestamps.size() > prices.size()) {
+                        timestamps.pop_back();
+                    }
+                }
+            }
+        }
+    }
+    
+    // Ensure arrays are the same size - trim timestamps if needed
+    while (timestamps.size() > prices.size() && !timestamps.empty()) {
+        timestamps.pop_back();
+    }
+}
+
+QuoteResult invalidSymbol(const std::string& symbol) {
+    QuoteResult result;
+    result.error = {ErrorCode::InvalidSymbol, "Invalid stock symbol: " + symbol};
+    return result;
+}
+
+QuoteResult quoteFromResponse(Response response, uint64_t ifChangedFrom) {
+    QuoteResult result;
+    result.data.lastFetchTime = currentTimestamp();
+    result.data.fetchDurationMs = response.durationMs;
+    result.timing = response.timing;
+    if (response.error) {
+        result.error = response.error;
+        return result;
+    }
+
+    // Skip parsing entirely when the body is byte-for-byte what the caller already has
+    result.fingerprint = Client::fingerprintOf(response.body);
+    if (ifChangedFrom != 0 && result.fingerprint == ifChangedFrom) {
+        result.unchanged = true;
+        return result;
+    }
+
+    result.error = Client::parseChart(response.body, result.data);
+    return result;
+}
+}
+
+// One queued or in-flight GET
+struct Transfer {
+    std::string url;
+    std::function<void(Response)> done;
+    Response response;
+    std::chrono::steady_clock::time_point start;
+    CURL* easy = nullptr;
+    std::string hostPort;
+    curl_slist* resolve = nullptr; // Must outlive the transfer
+    bool pinned = false;           // Connected to an address from the state file
+    bool retried = false;
+};
+
+// Drives every transfer for a client through one multi handle on a background
+// thread, so connections, DNS and TLS sessions are shared between callers
+struct Client::Engine {
+    ClientOptions options;
+    CURLM* multi = nullptr;
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Transfer>> pending;
+    std::vector<std::unique_ptr<Transfer>> active;
+    std::vector<CURL*> idleHandles;
+    bool stopping = false;
+    std::thread thread;
+
+    // Only touched from the engine thread once it is running
+    CURLSH* share = nullptr;
+    ClientState state;
+    bool sessionsImported = false;
+    bool stateSaved = false;
+
+    // Small pool that parses fetchQuote bodies so the engine thread only moves bytes;
+    // started by the first parse
+    std::mutex parseMutex;
+    std::condition_variable parseReady;
+    std::deque<std::function<void()>> parseQueue;
+    std::vector<std::thread> parsers;
+    bool parseStopping = false;
+
+    explicit Engine(const ClientOptions& options)
+        : options(options), state(options.statePath, options.dnsCacheSeconds) {
+        globalInit();
+        multi = curl_multi_init();
+        curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, options.maxConnections);
+        share = curl_share_init();
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        thread = std::thread(&Engine::run, this);
+    }
+
+    ~Engine() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        curl_multi_wakeup(multi);
+        thread.join();
+
+        // Parsers finish what is queued, so every future gets its value
+        {
+            std::lock_guard<std::mutex> lock(parseMutex);
+            parseStopping = true;
+        }
+        parseReady.notify_all();
+        for (auto& parser : parsers) {
+            parser.join();
+        }
+
+        if (!idleHandles.empty()) {
+            persist(idleHandles.back());
+        }
+        for (CURL* easy : idleHandles) {
+            curl_easy_cleanup(easy);
+        }
+        curl_multi_cleanup(multi);
+        curl_share_cleanup(share);
+        globalCleanup();
+    }
+
+    void parse(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(parseMutex);
+            if (parsers.empty()) {
+                unsigned count = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+                for (unsigned i = 0; i < count; i++) {
+                    parsers.emplace_back(&Engine::runParser, this);
+                }
+            }
+            parseQueue.push_back(std::move(task));
+        }
+        parseReady.notify_one();
+    }
+
+    void runParser() {
+        std::unique_lock<std::mutex> lock(parseMutex);
+        while (true) {
+            parseReady.wait(lock, [this] { return parseStopping || !parseQueue.empty(); });
+            if (parseQueue.empty()) return;
+            std::function<void()> task = std::move(parseQueue.front());
+            parseQueue.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+        userp->append((char*)contents, size * nmemb);
+        return size * nmemb;
+    }
+
+    void submit(const std::string& url, std::function<void(Response)> done) {
+        auto transfer = std::make_unique<Transfer>();
+        transfer->url = url;
+        transfer->done = std::move(done);
+        transfer->start = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!stopping) {
+                pending.push_back(std::move(transfer));
+            }
+        }
+        if (transfer) {
+            transfer->response.error = {ErrorCode::Cancelled, "Client is shutting down"};
+            transfer->done(std::move(transfer->response));
+            return;
+        }
+        curl_multi_wakeup(multi);
+    }
+
+    // Writes pinned addresses and the TLS sessions the share holds to the state file
+    void persist(CURL* easy) {
+        if (!state.enabled()) return;
+        curl_easy_setopt(easy, CURLOPT_SHARE, share);
+        state.exportSessions(easy);
+        state.save();
+    }
+
+    // Keeps at most one idle handle per connection; a burst of queued
+    // transfers would otherwise leave its peak count allocated for good
+    void recycle(CURL* easy) {
+        if ((long)idleHandles.size() < std::max(1L, options.maxConnections)) {
+            idleHandles.push_back(easy);
+        } else {
+            curl_easy_cleanup(easy);
+        }
+    }
+
+    void start(std::unique_ptr<Transfer> transfer) {
+        CURL* easy;
+        if (!idleHandles.empty()) {
+            easy = idleHandles.back();
+            idleHandles.pop_back();
+            curl_easy_reset(easy);
+        } else {
+            easy = curl_easy_init();
+        }
+        if (!easy) {
+            transfer->response.error = {ErrorCode::Network, "Failed to initialize curl"};
+            transfer->done(std::move(transfer->response));
+            return;
+        }
+
+        transfer->easy = easy;
+        curl_easy_setopt(easy, CURLOPT_SHARE, share);
+        if (state.enabled()) {
+            if (!sessionsImported) {
+                state.importSessions(easy);
+                sessionsImported = true;
+            }
+            // A pinned address skips the DNS lookup; keep connect short so a stale one fails fast
+            transfer->hostPort = hostPortOf(transfer->url);
+            transfer->pinned = state.isPinned(transfer->hostPort);
+            transfer->resolve = state.resolveFor(transfer->hostPort);
+            if (transfer->resolve) {
+                curl_easy_setopt(easy, CURLOPT_RESOLVE, transfer->resolve);
+            }
+            if (transfer->pinned) {
+                curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, std::min(5L, options.timeoutSeconds));
+            }
+        }
+        curl_easy_setopt(easy, CURLOPT_URL, transfer->url.c_str());
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->response.body);
+        curl_easy_setopt(easy, CURLOPT_USERAGENT, options.userAgent.c_str());
+        curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT, options.timeoutSeconds);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+        curl_multi_add_handle(multi, easy);
+        active.push_back(std::move(transfer));
+    }
+
+    void finish(CURL* easy, CURLcode result) {
+        Transfer* raw = nullptr;
+        curl_easy_getinfo(easy, CURLINFO_PRIVATE, (char**)&raw);
+        curl_multi_remove_handle(multi, easy);
+
+        auto it = std::find_if(active.begin(), active.end(),
+                               [raw](const std::unique_ptr<Transfer>& t) { return t.get() == raw; });
+        if (it == active.end()) return;
+        std::unique_ptr<Transfer> transfer = std::move(*it);
+        active.erase(it);
+        curl_slist_free_all(transfer->resolve);
+        transfer->resolve = nullptr;
+
+        Response& response = transfer->response;
+        recordTiming(easy, response.timing);
+
+        // A pinned address that no longer answers is dropped and the transfer retried once with a fresh lookup
+        bool staleAddress = result == CURLE_COULDNT_CONNECT || result == CURLE_SSL_CONNECT_ERROR ||
+                            result == CURLE_PEER_FAILED_VERIFICATION ||
+                            (result == CURLE_OPERATION_TIMEDOUT && response.timing.connectMs == 0.0);
+        if (transfer->pinned && !transfer->retried && staleAddress) {
+            state.forget(transfer->hostPort);
+            transfer->retried = true;
+            transfer->response.body.clear();
+            transfer->response.timing = Timing();
+            idleHandles.push_back(easy);
+            start(std::move(transfer));
+            return;
+        }
+
+        response.durationMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - transfer->start).count();
+        response.timing.totalMs = response.durationMs;
+        if (result != CURLE_OK) {
+            response.error = {ErrorCode::Network, "curl_easy_perform() failed: " + std::string(curl_easy_strerror(result))};
+        } else {
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.status);
+            if (response.status != 200) {
+                response.error = {ErrorCode::Http, "HTTP request failed with response code: " + std::to_string(response.status)};
+            }
+        }
+
+        bool saveNow = false;
+        if (state.enabled() && result == CURLE_OK) {
+            char* effectiveUrl = nullptr;
+            char* address = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_EFFECTIVE_URL, &effectiveUrl);
+            curl_easy_getinfo(easy, CURLINFO_PRIMARY_IP, &address);
+            if (effectiveUrl && address) {
+                state.remember(hostPortOf(effectiveUrl), address);
+            }
+            saveNow = !stateSaved;
+        }
+
+        transfer->done(std::move(response));
+
+        // Save as soon as there is something worth reusing, so a run killed with Ctrl+C
+        // still benefits, but only after the caller has its result
+        if (saveNow) {
+            persist(easy);
+            stateSaved = true;
+        }
+        recycle(easy);
+    }
+
+    // Per-phase breakdown of the last transfer, each phase measured on its own
+    static void recordTiming(CURL* easy, Timing& timing) {
+        curl_off_t lookup = 0, connect = 0, handshake = 0, firstByte = 0;
+        long connects = 0;
+        curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME_T, &lookup);
+        curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connect);
+        curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME_T, &handshake);
+        curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+        curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+
+        timing.dnsMs = lookup / 1000.0;
+        timing.connectMs = connect > lookup ? (connect - lookup) / 1000.0 : 0.0;
+        timing.tlsMs = handshake > connect ? (handshake - connect) / 1000.0 : 0.0;
+        timing.firstByteMs = firstByte / 1000.0;
+        timing.newConnection = connects > 0;
+    }
+
+    void run() {
+        while (true) {
+            std::deque<std::unique_ptr<Transfer>> incoming;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping) break;
+                incoming.swap(pending);
+            }
+            for (auto& transfer : incoming) {
+                start(std::move(transfer));
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            CURLMsg* msg;
+            int queued = 0;
+            while ((msg = curl_multi_info_read(multi, &queued))) {
+                if (msg->msg == CURLMSG_DONE) {
+                    finish(msg->easy_handle, msg->data.result);
+                }
+            }
+
+            curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+
+        // Anything left over is cancelled so no future is left waiting
+        std::deque<std::unique_ptr<Transfer>> leftover;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            leftover.swap(pending);
+        }
+        for (auto& transfer : active) {
+            curl_multi_remove_handle(multi, transfer->easy);
+            curl_slist_free_all(transfer->resolve);
+            transfer->resolve = nullptr;
+            recycle(transfer->easy);
+            leftover.push_back(std::move(transfer));
+        }
+        active.clear();
+        for (auto& transfer : leftover) {
+            transfer->response.error = {ErrorCode::Cancelled, "Client was destroyed before the transfer finished"};
+            transfer->done(std::move(transfer->response));
+        }
+    }
+};
+
+Client::Client(const ClientOptions& options) : options(options) {}
+
+// Nothing is initialised until the first transfer, so clients that only
+// validate or parse never load TLS libraries or start a thread
+Client::Engine& Client::ensureEngine() {
+    std::call_once(engineOnce, [this] {
+        engine.reset(new Engine(options));
+    });
+    return *engine;
+}
+
+Client::~Client() = default;
+
+Client& Client::shared() {
+    static Client client;
+    return client;
+}
+
+std::future<Response> Client::get(const std::string& url) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    std::future<Response> future = promise->get_future();
+    get(url, [promise](Response response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void Client::get(const std::string& url, std::function<void(Response)> callback) {
+    ensureEngine().submit(url, std::move(callback));
+}
+
+// The engine thread hands each body to the parse pool, so hundreds of
+// symbols don't queue up behind each other's parsing
+std::future<QuoteResult> Client::fetchQuote(const std::string& symbol, const std::string& exchange,
+                                            uint64_t ifChangedFrom) {
+    auto promise = std::make_shared<std::promise<QuoteResult>>();
+    std::future<QuoteResult> future = promise->get_future();
+    if (!isValidSymbol(symbol)) {
+        promise->set_value(invalidSymbol(symbol));
+        return future;
+    }
+
+    Engine* pool = &ensureEngine();
+    get(chartUrl(buildFullSymbol(symbol, exchange)), [pool, promise, ifChangedFrom](Response response) {
+        auto body = std::make_shared<Response>(std::move(response));
+        pool->parse([promise, body, ifChangedFrom] {
+            promise->set_value(quoteFromResponse(std::move(*body), ifChangedFrom));
+        });
+    });
+    return future;
+}
+
+void Client::fetchQuote(const std::string& symbol, const std::string& exchange, uint64_t ifChangedFrom,
+                        std::function<void(QuoteResult)> callback) {
+    if (!isValidSymbol(symbol)) {
+        callback(invalidSymbol(symbol));
+        return;
+    }
+
+    get(chartUrl(buildFullSymbol(symbol, exchange)), [ifChangedFrom, callback](Response response) {
+        callback(quoteFromResponse(std::move(response), ifChangedFrom));
+    });
+}
+
+// Let user specify the full symbol with exchange suffix
+// If exchange is provided and doesn't start with a dot, add it
+std::string Client::buildFullSymbol(const std::string& symbol, const std::string& exchange) {
+    std::string fullSymbol = symbol;
+    if (!exchange.empty() && exchange != "NASDAQ" && exchange != "NYSE") {
+        if (exchange[0] != '.') {
+            fullSymbol += "." + exchange;
+        } else {
+            fullSymbol += exchange;
+        }
+    }
+    return fullSymbol;
+}
+
+std::string Client::chartUrl(const std::string& fullSymbol, const std::string& query) {
+    std::string url = "https://query1.finance.yahoo.com/v8/finance/chart/" + fullSymbol;
+    if (!query.empty()) {
+        url += "?" + query;
+    }
+    return url;
+}
+
+bool Client::isValidSymbol(const std::string& symbol) {
+    // Basic validation - not empty and contains only alphanumeric characters,
+    // plus the '.', '-' and '=' Yahoo uses for suffixes, share classes and FX pairs
+    if (symbol.empty()) return false;
+    for (char c : symbol) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '=') return false;
+    }
+    return true;
+}
+
+Error Client::parseChart(const std::string& jsonData, StockData& stockData) {
+    // Check if the response contains valid data
+    if (jsonData.find("\"result\":null") != std::string::npos ||
+        jsonData.find("\"result\":[]") != std::string::npos) {
+        return {ErrorCode::NoData, "No data found for this symbol/exchange combination."};
+    }
+
+    // More specific error checking - look for actual error structure
+    if (jsonData.find("\"chart\":{\"error\"") != std::string::npos) {
+        return {ErrorCode::ApiError, "API returned an error."};
+    }
+
+    // Save timing info before resetting stockData
+    std::string savedFetchTime = stockData.lastFetchTime;
+    double savedFetchDuration = stockData.fetchDurationMs;
+
+    stockData = StockData();
+
+    // Restore timing info
+    stockData.lastFetchTime = savedFetchTime;
+    stockData.fetchDurationMs = savedFetchDuration;
+
+    try {
+        // Extract meta information from the first result
+        size_t metaPos = jsonData.find("\"meta\":");
+        if (metaPos == std::string::npos) {
+            return {ErrorCode::NoData, "No data found for this symbol/exchange combination."};
+        }
+
+        // Extract from meta section
+        stockData.symbol = extractStringFromMeta(jsonData, "symbol");
+        stockData.name = extractStringFromMeta(jsonData, "longName");
+        if (stockData.name.empty()) {
+            stockData.name = extractStringFromMeta(jsonData, "shortName");
+        }
+        stockData.currency = extractStringFromMeta(jsonData, "currency");
+        stockData.exchange = extractStringFromMeta(jsonData, "exchangeName");
+
+        // Extract price data from meta section
+        stockData.currentPrice = extractDoubleFromMeta(jsonData, "regularMarketPrice");
+        stockData.previousClose = extractDoubleFromMeta(jsonData, "previousClose");
+        stockData.dayHigh = extractDoubleFromMeta(jsonData, "regularMarketDayHigh");
+        stockData.dayLow = extractDoubleFromMeta(jsonData, "regularMarketDayLow");
+        stockData.fiftyTwoWeekHigh = extractDoubleFromMeta(jsonData, "fiftyTwoWeekHigh");
+        stockData.fiftyTwoWeekLow = extractDoubleFromMeta(jsonData, "fiftyTwoWeekLow");
+        stockData.volume = extractLongFromMeta(jsonData, "regularMarketVolume");
+
+        // If regularMarketPrice is 0, try chartPreviousClose as current price
+        if (stockData.currentPrice == 0.0) {
+            stockData.currentPrice = extractDoubleFromMeta(jsonData, "chartPreviousClose");
+        }
+
+        // Extract price array for graph from indicators.quote[0].close
+        extractPriceArrayFromIndicators(jsonData, stockData.prices, stockData.timestamps);
+
+        stockData.hasData = (stockData.currentPrice > 0);
+
+    } catch (...) {
+        stockData.hasData = false;
+    }
+    return {};
+}
+
+uint64_t Client::fingerprintOf(const std::string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+}
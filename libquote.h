@@ -0,0 +1,135 @@
+#pragma once
+#include<cstdint>
+#include<functional>
+#include<future>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<vector>
+
+namespace quote {
+// Stock data structure
+struct StockData {
+    std::string symbol;
+    std::string name;
+    std::string currency;
+    std::string exchange;
+    double currentPrice = 0.0;
+    double previousClose = 0.0;
+    double dayHigh = 0.0;
+    double dayLow = 0.0;
+    double fiftyTwoWeekHigh = 0.0;
+    double fiftyTwoWeekLow = 0.0;
+    long volume = 0;
+    std::vector<double> prices;
+    std::vector<long> timestamps;
+    bool hasData = false;
+    std::string lastFetchTime = "";
+    double fetchDurationMs = 0.0;
+};
+
+// What went wrong with a call, instead of printing it
+enum class ErrorCode {
+    None,
+    InvalidSymbol, // Symbol failed validation, nothing was sent
+    Network,       // Transfer failed (DNS, connect, TLS, timeout)
+    Http,          // Server answered with a non-200 status
+    NoData,        // Symbol/exchange combination has no chart data
+    ApiError,      // Server returned an error payload
+    Cancelled      // Client was destroyed before the transfer finished
+};
+
+struct Error {
+    ErrorCode code = ErrorCode::None;
+    std::string message;
+
+    explicit operator bool() const {
+        return code != ErrorCode::None;
+    }
+};
+
+// Where the time of one transfer went; phases that were skipped stay at zero
+struct Timing {
+    double dnsMs = 0.0;
+    double connectMs = 0.0;
+    double tlsMs = 0.0;
+    double firstByteMs = 0.0;   // From the start of the transfer
+    double totalMs = 0.0;
+    bool newConnection = false; // False when an open connection was reused
+};
+
+// Raw result of a GET through the transfer engine
+struct Response {
+    Error error;
+    long status = 0;
+    std::string body;
+    double durationMs = 0.0;
+    Timing timing;
+};
+
+// Result of a quote fetch
+struct QuoteResult {
+    Error error;
+    StockData data;
+    uint64_t fingerprint = 0; // Hash of the response body
+    bool unchanged = false;   // Body matched the fingerprint passed in, data was not parsed
+    Timing timing;
+};
+
+struct ClientOptions {
+    long timeoutSeconds = 30;
+    long maxConnections = 8; // Concurrent transfers across all callers
+    std::string userAgent = "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36";
+    std::string statePath; // File that keeps DNS results and TLS sessions between runs, empty to disable
+    long dnsCacheSeconds = 300; // How long a saved address is trusted before it is looked up again
+};
+
+// Thread-safe quote client. All calls may be made from any thread; transfers
+// share one connection pool driven by a background thread, and callbacks run
+// on that thread, so they should hand off heavy work. The thread and libcurl
+// are only started by the first transfer.
+class Client {
+public:
+    explicit Client(const ClientOptions& options = ClientOptions());
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    // Fetches and parses a quote. If ifChangedFrom matches the new body's
+    // fingerprint, the result is flagged unchanged and parsing is skipped.
+    // The future form parses on a small pool owned by the client; the
+    // callback form parses on the engine thread. An invalid symbol is
+    // reported at once, on the calling thread, since nothing is sent.
+    std::future<QuoteResult> fetchQuote(const std::string& symbol, const std::string& exchange = "",
+                                        uint64_t ifChangedFrom = 0);
+    void fetchQuote(const std::string& symbol, const std::string& exchange, uint64_t ifChangedFrom,
+                    std::function<void(QuoteResult)> callback);
+
+    // Plain GET through the shared engine
+    std::future<Response> get(const std::string& url);
+    void get(const std::string& url, std::function<void(Response)> callback);
+
+    // Process-wide client for callers that don't manage their own
+    static Client& shared();
+
+    // Symbol helpers
+    static std::string buildFullSymbol(const std::string& symbol, const std::string& exchange);
+    static std::string chartUrl(const std::string& fullSymbol, const std::string& query = "");
+    static bool isValidSymbol(const std::string& symbol);
+
+    // Parses a chart response body
+    static Error parseChart(const std::string& body, StockData& data);
+
+    // FNV-1a over a response body, cheap enough to run on every tick
+    static uint64_t fingerprintOf(const std::string& data);
+
+private:
+    struct Engine;
+    ClientOptions options;
+    std::once_flag engineOnce;
+    std::unique_ptr<Engine> engine;
+
+    Engine& ensureEngine();
+};
+}
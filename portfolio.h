@@ -0,0 +1,460 @@
+#pragma once
+#include "libquote.h"
+#include<algorithm>
+#include<chrono>
+#include<cmath>
+#include<fstream>
+#include<future>
+#include<iomanip>
+#include<iostream>
+#include<sstream>
+#include<string>
+#include<unordered_map>
+#include<vector>
+
+namespace quote {
+// One line of the holdings file
+struct Lot {
+    std::string symbol;
+    double quantity = 0.0;
+    double cost = 0.0;    // Per-unit cost in the units the symbol is quoted in
+    bool hasCost = false;
+    int line = 0;
+};
+
+// FX rates into one base currency, fetched together and reused for a refresh window
+class FxCache {
+private:
+    struct Rate {
+        double value = 0.0;
+        std::chrono::steady_clock::time_point fetchedAt;
+        bool valid = false;
+    };
+
+    std::string base;
+    std::chrono::duration<double> window;
+    std::unordered_map<std::string, Rate> rates;
+
+public:
+    FxCache(const std::string& base, double windowSeconds)
+        : base(base), window(windowSeconds) {}
+
+    const std::string& baseCurrency() const {
+        return base;
+    }
+
+    // Returns 0 if the rate is not known yet
+    double rate(const std::string& currency) const {
+        if (currency == base) return 1.0;
+        auto found = rates.find(currency);
+        return found != rates.end() && found->second.valid ? found->second.value : 0.0;
+    }
+
+    // Fetches every stale rate at once; returns the currencies whose rate moved
+    std::vector<std::string> refresh(Client& client, const std::vector<std::string>& currencies) {
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::string> stale;
+        for (const auto& currency : currencies) {
+            if (currency == base || currency.empty()) continue;
+            auto found = rates.find(currency);
+            if (found == rates.end() || !found->second.valid || now - found->second.fetchedAt >= window) {
+                stale.push_back(currency);
+            }
+        }
+
+        std::vector<std::future<QuoteResult>> pending;
+        for (const auto& currency : stale) {
+            pending.push_back(client.fetchQuote(currency + base + "=X"));
+        }
+
+        std::vector<std::string> changed;
+        for (size_t i = 0; i < stale.size(); i++) {
+            QuoteResult result = pending[i].get();
+            Rate& entry = rates[stale[i]];
+            if (result.error || !result.data.hasData) {
+                // Keep serving the old rate; try again next tick
+                if (entry.valid) entry.fetchedAt = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(window);
+                continue;
+            }
+            if (!entry.valid || entry.value != result.data.currentPrice) {
+                changed.push_back(stale[i]);
+            }
+            entry.value = result.data.currentPrice;
+            entry.fetchedAt = now;
+            entry.valid = true;
+        }
+        return changed;
+    }
+};
+
+// Values a holdings file in one base currency, updating P&L incrementally:
+// a tick only recomputes the holdings whose quote changed, and an FX move only
+// rescales that currency's subtotal
+class Portfolio {
+private:
+    // All lots of one symbol, with their contribution in the quote's major currency
+    struct Holding {
+        std::string symbol;
+        double quantity = 0.0;
+        double costedQuantity = 0.0;
+        double costBasis = 0.0;
+        uint64_t fingerprint = 0;
+        bool hasData = false;
+        std::string quotedCurrency;
+        double scale = 1.0; // Minor-unit quotes such as GBp are scaled to major units
+        int bucket = -1;
+        double price = 0.0;
+        double dayChangePercent = 0.0;
+        double value = 0.0;
+        double cost = 0.0;
+        double unrealized = 0.0;
+        double day = 0.0;
+    };
+
+    // Sum of holdings in one currency, kept both locally and in the base currency
+    struct Bucket {
+        std::string currency;
+        double value = 0.0;
+        double cost = 0.0;
+        double unrealized = 0.0;
+        double day = 0.0;
+        double rate = 0.0;
+        double baseValue = 0.0;
+        double baseCost = 0.0;
+        double baseUnrealized = 0.0;
+        double baseDay = 0.0;
+        size_t holdings = 0;
+        bool dirty = false;
+    };
+
+    std::vector<Holding> holdings;
+    std::vector<Bucket> buckets;
+    std::unordered_map<std::string, int> bucketIndex;
+    std::string exchange;
+    FxCache fx;
+
+    double totalValue = 0.0;
+    double totalCost = 0.0;
+    double totalUnrealized = 0.0;
+    double totalDay = 0.0;
+    size_t lastRecomputed = 0;
+    size_t lastFailed = 0;    // Holdings whose fetch failed on the last refresh
+    std::string lastError;    // First of those errors, as a sample
+    long unchangedTicks = 0;
+
+    // Yahoo quotes some exchanges in minor units
+    static void normalizeCurrency(const std::string& quoted, std::string& currency, double& scale) {
+        if (quoted == "GBp" || quoted == "GBX") {
+            currency = "GBP";
+            scale = 0.01;
+        } else if (quoted == "ZAc") {
+            currency = "ZAR";
+            scale = 0.01;
+        } else if (quoted == "ILA") {
+            currency = "ILS";
+            scale = 0.01;
+        } else {
+            currency = quoted;
+            scale = 1.0;
+        }
+    }
+
+    int bucketFor(const std::string& currency) {
+        auto found = bucketIndex.find(currency);
+        if (found != bucketIndex.end()) return found->second;
+        Bucket bucket;
+        bucket.currency = currency;
+        bucket.rate = fx.rate(currency);
+        buckets.push_back(bucket);
+        bucketIndex[currency] = buckets.size() - 1;
+        return buckets.size() - 1;
+    }
+
+    // Moves a holding's contribution out of (sign -1) or into (sign +1) its bucket
+    void contribute(const Holding& holding, double sign) {
+        if (holding.bucket < 0) return;
+        Bucket& bucket = buckets[holding.bucket];
+        bucket.value += sign * holding.value;
+        bucket.cost += sign * holding.cost;
+        bucket.unrealized += sign * holding.unrealized;
+        bucket.day += sign * holding.day;
+        if (sign > 0) {
+            bucket.holdings++;
+        } else {
+            bucket.holdings--;
+        }
+        bucket.dirty = true;
+    }
+
+    void update(Holding& holding, const StockData& data) {
+        contribute(holding, -1);
+
+        if (data.currency != holding.quotedCurrency || holding.bucket < 0) {
+            std::string currency;
+            normalizeCurrency(data.currency, currency, holding.scale);
+            holding.quotedCurrency = data.currency;
+            holding.bucket = bucketFor(currency);
+        }
+
+        holding.hasData = data.hasData;
+        holding.price = data.currentPrice;
+        holding.dayChangePercent = data.previousClose > 0
+            ? (data.currentPrice - data.previousClose) / data.previousClose * 100.0
+            : 0.0;
+        holding.value = holding.quantity * data.currentPrice * holding.scale;
+        holding.cost = holding.costBasis * holding.scale;
+        holding.unrealized = holding.costedQuantity * data.currentPrice * holding.scale - holding.cost;
+        holding.day = data.previousClose > 0
+            ? holding.quantity * (data.currentPrice - data.previousClose) * holding.scale
+            : 0.0;
+
+        contribute(holding, +1);
+    }
+
+    // Re-derives the base-currency subtotal of each touched bucket and folds the difference into the totals
+    void settleBuckets() {
+        for (Bucket& bucket : buckets) {
+            double rate = fx.rate(bucket.currency);
+            if (!bucket.dirty && rate == bucket.rate) continue;
+
+            totalValue -= bucket.baseValue;
+            totalCost -= bucket.baseCost;
+            totalUnrealized -= bucket.baseUnrealized;
+            totalDay -= bucket.baseDay;
+
+            bucket.rate = rate;
+            bucket.baseValue = bucket.value * rate;
+            bucket.baseCost = bucket.cost * rate;
+            bucket.baseUnrealized = bucket.unrealized * rate;
+            bucket.baseDay = bucket.day * rate;
+            bucket.dirty = false;
+
+            totalValue += bucket.baseValue;
+            totalCost += bucket.baseCost;
+            totalUnrealized += bucket.baseUnrealized;
+            totalDay += bucket.baseDay;
+        }
+    }
+
+    static std::string signedAmount(double value) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2) << std::showpos << value;
+        return ss.str();
+    }
+
+    static std::string color(double value) {
+        return value >= 0 ? "\033[32m" : "\033[31m";
+    }
+
+public:
+    Portfolio(const std::string& exchange, const std::string& baseCurrency, double fxRefreshSeconds)
+        : exchange(exchange), fx(baseCurrency, fxRefreshSeconds) {}
+
+    // Loads holdings, one lot per line: SYMBOL QUANTITY [COST]; '#' starts a comment.
+    // Lots of the same symbol are merged so each symbol is fetched once.
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "Cannot open holdings file: " + path;
+            return false;
+        }
+
+        std::unordered_map<std::string, size_t> bySymbol;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            std::istringstream ss(line);
+            Lot lot;
+            lot.line = lineNumber;
+            if (!(ss >> lot.symbol)) continue;
+            std::transform(lot.symbol.begin(), lot.symbol.end(), lot.symbol.begin(),
+                           [](unsigned char c) { return std::toupper(c); });
+            if (!Client::isValidSymbol(lot.symbol)) {
+                error = path + ":" + std::to_string(lineNumber) + ": invalid symbol '" + lot.symbol + "'";
+                return false;
+            }
+            if (!(ss >> lot.quantity)) {
+                error = path + ":" + std::to_string(lineNumber) + ": expected SYMBOL QUANTITY [COST]";
+                return false;
+            }
+            if (ss >> lot.cost) {
+                lot.hasCost = true;
+            } else if (!ss.eof()) {
+                error = path + ":" + std::to_string(lineNumber) + ": cost must be a number";
+                return false;
+            }
+
+            auto found = bySymbol.find(lot.symbol);
+            if (found == bySymbol.end()) {
+                Holding holding;
+                holding.symbol = lot.symbol;
+                holdings.push_back(holding);
+                found = bySymbol.emplace(lot.symbol, holdings.size() - 1).first;
+            }
+            Holding& holding = holdings[found->second];
+            holding.quantity += lot.quantity;
+            if (lot.hasCost) {
+                holding.costedQuantity += lot.quantity;
+                holding.costBasis += lot.quantity * lot.cost;
+            }
+        }
+        return true;
+    }
+
+    // Fetches every holding and any stale FX rates, recomputing only what changed;
+    // returns false if nothing moved
+    bool refresh(Client& client) {
+        std::vector<std::future<QuoteResult>> pending;
+        pending.reserve(holdings.size());
+        for (const Holding& holding : holdings) {
+            pending.push_back(client.fetchQuote(holding.symbol, exchange, holding.fingerprint));
+        }
+
+        lastRecomputed = 0;
+        lastFailed = 0;
+        lastError.clear();
+        for (size_t i = 0; i < holdings.size(); i++) {
+            QuoteResult result = pending[i].get();
+            if (result.error) {
+                // Counted rather than printed: one line per symbol would flood a large book
+                if (lastFailed++ == 0) {
+                    lastError = holdings[i].symbol + ": " + result.error.message;
+                }
+                continue;
+            }
+            if (result.unchanged) {
+                unchangedTicks++;
+                continue;
+            }
+            holdings[i].fingerprint = result.fingerprint;
+            update(holdings[i], result.data);
+            lastRecomputed++;
+        }
+
+        std::vector<std::string> currencies;
+        for (const Bucket& bucket : buckets) {
+            currencies.push_back(bucket.currency);
+        }
+        bool ratesMoved = !fx.refresh(client, currencies).empty();
+        settleBuckets();
+        return lastRecomputed > 0 || ratesMoved;
+    }
+
+    // Holdings recomputed by the last refresh
+    size_t recomputed() const {
+        return lastRecomputed;
+    }
+
+    size_t size() const {
+        return holdings.size();
+    }
+
+    // Holdings that failed to fetch on the last refresh, and the first such error
+    size_t failed() const {
+        return lastFailed;
+    }
+
+    const std::string& firstError() const {
+        return lastError;
+    }
+
+    long skipped() const {
+        return unchangedTicks;
+    }
+
+    void displaySummary(std::ostream& out, size_t movers = 10) const {
+        std::string bold = "\033[1m";
+        std::string dim = "\033[2m";
+        std::string reset = "\033[0m";
+        const std::string& base = fx.baseCurrency();
+
+        out << "\n" << std::string(80, '=') << "\n"
+            << bold << "  PORTFOLIO (" << holdings.size() << " holdings, base " << base << ")" << reset << "\n"
+            << std::string(80, '=') << "\n";
+
+        // Buckets without a rate add nothing to the totals, so say which ones are missing
+        std::string excluded;
+        for (const Bucket& bucket : buckets) {
+            if (bucket.holdings > 0 && bucket.rate <= 0) {
+                excluded += (excluded.empty() ? "" : ", ") + bucket.currency;
+            }
+        }
+        std::string incomplete = excluded.empty() ? "" : " " + dim + "(excl. " + excluded + ", no FX)" + reset;
+
+        double unrealizedPercent = totalCost != 0 ? totalUnrealized / totalCost * 100.0 : 0.0;
+        double dayPercent = totalValue - totalDay != 0 ? totalDay / (totalValue - totalDay) * 100.0 : 0.0;
+        out << bold << "Market Value: " << reset << std::fixed << std::setprecision(2) << totalValue << " " << base
+            << incomplete << "\n"
+            << bold << "Day P&L:      " << reset << color(totalDay) << signedAmount(totalDay) << " " << base
+            << " (" << signedAmount(dayPercent) << "%)" << reset << incomplete << "\n"
+            << bold << "Unrealized:   " << reset << color(totalUnrealized) << signedAmount(totalUnrealized) << " " << base
+            << " (" << signedAmount(unrealizedPercent) << "%)" << reset << incomplete << "\n";
+
+        out << "\n" << bold << std::left << std::setw(6) << "CCY" << std::right << std::setw(8) << "HOLD"
+            << std::setw(14) << "RATE" << std::setw(18) << "VALUE" << std::setw(16) << "DAY P&L" << reset << "\n";
+        for (const Bucket& bucket : buckets) {
+            out << std::left << std::setw(6) << bucket.currency << std::right << std::setw(8) << bucket.holdings;
+            if (bucket.rate > 0) {
+                out << std::setw(14) << std::setprecision(4) << bucket.rate
+                    << std::setw(18) << std::setprecision(2) << bucket.baseValue
+                    << color(bucket.baseDay) << std::setw(16) << signedAmount(bucket.baseDay) << reset << "\n";
+            } else {
+                out << dim << std::setw(14) << "no FX" << reset << "\n";
+            }
+        }
+
+        if (movers > 0) {
+            std::vector<const Holding*> ranked;
+            for (const Holding& holding : holdings) {
+                if (holding.hasData && buckets[holding.bucket].rate > 0) ranked.push_back(&holding);
+            }
+            size_t count = std::min(movers, ranked.size());
+            std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                              [this](const Holding* a, const Holding* b) {
+                                  return std::abs(a->day * buckets[a->bucket].rate) > std::abs(b->day * buckets[b->bucket].rate);
+                              });
+            out << "\n" << bold << "Top movers" << reset << "\n";
+            for (size_t i = 0; i < count; i++) {
+                const Holding& holding = *ranked[i];
+                double rate = buckets[holding.bucket].rate;
+                out << std::left << std::setw(12) << holding.symbol << std::right
+                    << std::setw(12) << std::setprecision(2) << holding.price << " " << std::left << std::setw(4) << holding.quotedCurrency
+                    << color(holding.day) << std::right << std::setw(9) << signedAmount(holding.dayChangePercent) << "%"
+                    << std::setw(16) << signedAmount(holding.day * rate) << " " << base << reset << "\n";
+            }
+        }
+    }
+
+    // Full per-holding table, for single-shot use
+    void displayHoldings(std::ostream& out) const {
+        std::string bold = "\033[1m";
+        std::string dim = "\033[2m";
+        std::string reset = "\033[0m";
+        const std::string& base = fx.baseCurrency();
+
+        out << "\n" << bold << std::left << std::setw(12) << "SYMBOL" << std::right << std::setw(12) << "QTY"
+            << std::setw(12) << "PRICE" << "  " << std::left << std::setw(4) << "CCY" << std::right
+            << std::setw(16) << "VALUE " + base << std::setw(14) << "DAY P&L" << std::setw(14) << "UNREALIZED" << reset << "\n";
+        for (const Holding& holding : holdings) {
+            out << std::left << std::setw(12) << holding.symbol << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << holding.quantity;
+            double rate = holding.bucket >= 0 ? buckets[holding.bucket].rate : 0.0;
+            if (!holding.hasData || rate <= 0) {
+                out << dim << std::setw(12) << "n/a" << reset << "\n";
+                continue;
+            }
+            out << std::setw(12) << holding.price << "  " << std::left << std::setw(4) << holding.quotedCurrency << std::right
+                << std::setw(16) << holding.value * rate
+                << color(holding.day) << std::setw(14) << signedAmount(holding.day * rate) << reset;
+            if (holding.costedQuantity > 0) {
+                out << color(holding.unrealized) << std::setw(14) << signedAmount(holding.unrealized * rate) << reset;
+            }
+            out << "\n";
+        }
+    }
+};
+}
@@ -1,4 +1,8 @@
 #include "quote.h"
+#include "backfill.h"
+#include "alerts.h"
+#include "grid.h"
+#include "portfolio.h"
 #include <iostream>
 #include <string>
 #include <cstring>
@@ -6,6 +10,8 @@
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
+#include <fstream>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
 volatile bool running = true;
@@ -15,11 +21,290 @@ void signalHandler(int signal) {
     std::cout << "\n\nShutting down gracefully...\n" << std::endl;
 }
 
+void printUsage(const char* program, bool withExamples) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "Options:\n"
+              << "  -s, --symbol SYMBOL      Specify the stock symbol (required)\n"
+              << "  -e, --exchange EXCHANGE  Specify the exchange suffix (default: none for US stocks)\n"
+              << "                           Examples: TO (TSX), L (LSE), DE (XETRA),\n"
+              << "                           PA (Euronext), AX (ASX), HK (Hong Kong), NS (NSE)\n"
+              << "  -w, --watch              Enable continuous monitoring mode\n"
+              << "  -i, --interval SECONDS   Refresh interval for watch mode (default: 2.0 seconds, min: 0.1)\n"
+              << "  -b, --backfill           Download historical bars (-s accepts SYM1,SYM2,...)\n"
+              << "      --from DATE          Backfill start date, YYYY-MM-DD (required with -b)\n"
+              << "      --to DATE            Backfill end date, YYYY-MM-DD, inclusive (default: now)\n"
+              << "      --bar INTERVAL       Backfill bar size: 1m, 5m, 15m, 1h, 1d, 1wk, 1mo (default: 1d)\n"
+              << "  -o, --output DIR         Backfill output directory (default: .)\n"
+              << "  -j, --jobs N             Concurrent connections for backfill, grid, portfolio and alerts (default: 4)\n"
+              << "      --rate N             Max backfill requests per second (default: 4)\n"
+              << "  -g, --grid               Compact sparkline grid for many symbols (-s SYM1,SYM2,...)\n"
+              << "      --watchlist FILE     Read grid symbols from FILE, one per line\n"
+              << "      --frame-budget MS    Max time spent repainting the grid per tick (default: 15)\n"
+              << "  -p, --portfolio FILE     Value a holdings file (SYMBOL QTY [COST] per line), add -w to watch\n"
+              << "      --base CCY           Portfolio base currency (default: USD)\n"
+              << "      --fx-refresh SECONDS How long FX rates are reused (default: 300)\n"
+              << "  -a, --alerts FILE        Evaluate alert rules from FILE on every refresh (no -s needed)\n"
+              << "      --alert-log FILE     Also append triggered alerts to FILE\n"
+              << "      --alert-exec CMD     Run CMD per alert with the alert line on stdin (repeatable)\n"
+              << "      --timing             Print time to first quote and where it went (stderr)\n"
+              << "      --no-state           Don't reuse or save DNS results and TLS sessions between runs\n"
+              << "  -h, --help               Show this help message\n";
+    if (withExamples) {
+        std::cout << "\nExamples:\n"
+                  << "  " << program << " -s TSLA           # Single quote fetch (US stock)\n"
+                  << "  " << program << " -s SHOP -e TO     # Toronto Stock Exchange\n"
+                  << "  " << program << " -s VOD -e L       # London Stock Exchange\n"
+                  << "  " << program << " -s AAPL -w        # Watch mode with 2.0s real-time updates\n"
+                  << "  " << program << " -s MSFT -w -i 0.1 # Ultra-fast 100ms updates\n"
+                  << "  " << program << " -s TSLA -w -i 5   # Watch mode with 5s intervals\n"
+                  << "  " << program << " -s AAPL,MSFT -b --from 2015-01-01 -o data\n"
+                  << "                           # Ten years of daily bars per symbol\n"
+                  << "  " << program << " -a rules.txt -i 5   # Check alert rules every 5 seconds\n"
+                  << "  " << program << " -g --watchlist sp500.txt -i 5\n"
+                  << "                           # Whole watchlist on one screen\n"
+                  << "  " << program << " -p holdings.txt --base EUR -w\n"
+                  << "                           # Live P&L in euros\n";
+    }
+}
+
+// $XDG_CACHE_HOME/quote/state, falling back to ~/.cache/quote/state
+std::string defaultStatePath() {
+    const char* cache = std::getenv("XDG_CACHE_HOME");
+    if (cache && *cache) return std::string(cache) + "/quote/state";
+    const char* home = std::getenv("HOME");
+    if (home && *home) return std::string(home) + "/.cache/quote/state";
+    return "";
+}
+
+void printTiming(const quote::Timing& timing, bool gotQuote, std::chrono::steady_clock::time_point processStart) {
+    double sinceStart = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+    std::cerr << std::fixed << std::setprecision(1)
+              << (gotQuote ? "Time to first quote: " : "No quote after: ") << sinceStart << "ms"
+              << " (dns " << timing.dnsMs << "ms, connect " << timing.connectMs << "ms, tls " << timing.tlsMs
+              << "ms, first byte " << timing.firstByteMs << "ms, transfer " << timing.totalMs << "ms";
+    // A transfer that failed before connecting neither opened nor reused a connection
+    if (timing.newConnection) {
+        std::cerr << ", new connection";
+    } else if (gotQuote) {
+        std::cerr << ", reused connection";
+    }
+    std::cerr << ")" << std::endl;
+}
+
+// Terminal width, or 0 when stdout is not a terminal
+int terminalColumns() {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) return ws.ws_col;
+    return 0;
+}
+
+// Splits a comma-separated symbol list, rejecting invalid symbols
+bool parseSymbolList(const std::string& list, std::vector<std::string>& symbols) {
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        if (!quote::Client::isValidSymbol(item)) {
+            std::cerr << "Error: Invalid stock symbol: " << item << std::endl;
+            return false;
+        }
+        symbols.push_back(item);
+    }
+    return true;
+}
+
+// Reads one symbol per line, '#' starts a comment
+bool readWatchlist(const std::string& path, std::vector<std::string>& symbols) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Error: Cannot open watchlist: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream ss(line);
+        std::string item;
+        while (ss >> item) {
+            if (!parseSymbolList(item, symbols)) return false;
+        }
+    }
+    return true;
+}
+
+int runGrid(const std::vector<std::string>& symbols, const std::string& exchange, double refreshInterval,
+            const quote::ClientOptions& clientOptions, double frameBudgetMs) {
+    quote::Client client(clientOptions);
+    quote::Grid grid(symbols, exchange, client, frameBudgetMs);
+
+    std::cout << "\033[?25l\033[2J" << std::flush;
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(refreshInterval));
+    while (running) {
+        // refresh() may already have used most of the tick waiting on slow symbols
+        auto tickEnd = std::chrono::steady_clock::now() + interval;
+        grid.refresh(refreshInterval);
+        grid.render(refreshInterval);
+
+        if (running) {
+            std::this_thread::sleep_until(tickEnd);
+        }
+    }
+
+    std::cout << "\033[?25h\033[2J\033[H" << std::flush;
+    std::cout << "Monitoring stopped. Skipped " << grid.skipped() << " unchanged update(s).\n" << std::endl;
+    return 0;
+}
+
+int runPortfolio(const std::string& path, const std::string& exchange, const std::string& baseCurrency,
+                 double fxRefreshSeconds, bool watchMode, double refreshInterval,
+                 const quote::ClientOptions& clientOptions) {
+    quote::Portfolio portfolio(exchange, baseCurrency, fxRefreshSeconds);
+    std::string error;
+    if (!portfolio.load(path, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    quote::Client client(clientOptions);
+
+    if (!watchMode) {
+        portfolio.refresh(client);
+        if (portfolio.failed() > 0) {
+            std::cerr << "Error: " << portfolio.failed() << " of " << portfolio.size()
+                      << " holding(s) failed to fetch, e.g. " << portfolio.firstError() << std::endl;
+        }
+        portfolio.displaySummary(std::cout, 0);
+        portfolio.displayHoldings(std::cout);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    std::cout << "\033[?25l" << std::flush;
+    bool drawn = false;
+    while (running) {
+        bool changed = portfolio.refresh(client);
+
+        auto now = std::chrono::system_clock::now();
+        auto time_t = std::chrono::system_clock::to_time_t(now);
+        std::ostringstream header;
+        header << "Every " << refreshInterval << "s: quote -p " << path
+               << "    " << std::put_time(std::localtime(&time_t), "%a %b %d %H:%M:%S %Y")
+               << "    recomputed " << portfolio.recomputed() << "/" << portfolio.size();
+        if (portfolio.failed() > 0) {
+            // Kept short so the header never wraps into the frame
+            header << "    \033[31m" << portfolio.failed() << " failed\033[0m";
+        }
+
+        if (changed || !drawn) {
+            std::ostringstream frame;
+            frame << header.str() << "\n";
+            portfolio.displaySummary(frame);
+            std::cout << "\033[2J\033[H" << frame.str() << std::flush;
+            drawn = true;
+        } else {
+            // Totals are unchanged: only the header clock moves
+            std::cout << "\033[1;1H\033[2K" << header.str() << std::flush;
+        }
+
+        if (running) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(refreshInterval));
+        }
+    }
+
+    std::cout << "\033[?25h" << std::flush;
+    std::cout << "\nMonitoring stopped. Skipped " << portfolio.skipped() << " unchanged update(s).\n" << std::endl;
+    return 0;
+}
+
+int runAlerts(const std::string& rulesFile, const std::string& logFile, const std::vector<std::string>& hooks,
+              const std::string& exchange, double refreshInterval, const quote::ClientOptions& clientOptions) {
+    quote::AlertEngine engine;
+    std::string error;
+    if (!engine.loadRules(rulesFile, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    quote::AlertDispatcher dispatcher;
+    dispatcher.addSink(quote::AlertDispatcher::stdoutSink());
+    if (!logFile.empty()) {
+        dispatcher.addSink(quote::AlertDispatcher::fileSink(logFile));
+    }
+    for (const auto& hook : hooks) {
+        dispatcher.addSink(quote::AlertDispatcher::execSink(hook));
+    }
+    // A hook that exits without reading its stdin must not take the whole process down
+    signal(SIGPIPE, SIG_IGN);
+    dispatcher.start();
+
+    const std::vector<std::string>& symbols = engine.symbols();
+    std::vector<uint64_t> fingerprints(symbols.size(), 0);
+
+    quote::Client client(clientOptions);
+
+    std::cout << "Watching " << engine.ruleCount() << " rule(s) on " << symbols.size()
+              << " symbol(s) every " << refreshInterval << "s. Press Ctrl+C to stop." << std::endl;
+
+    while (running) {
+        // Fetch every symbol at once, then evaluate whatever changed on this thread
+        std::vector<std::future<quote::QuoteResult>> pending;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            pending.push_back(client.fetchQuote(symbols[i], exchange, fingerprints[i]));
+        }
+
+        for (size_t i = 0; i < symbols.size(); i++) {
+            quote::QuoteResult result = pending[i].get();
+            if (result.error) {
+                std::cerr << "Error: " << symbols[i] << ": " << result.error.message << std::endl;
+                continue;
+            }
+            if (result.unchanged) continue;
+            fingerprints[i] = result.fingerprint;
+            engine.evaluate(symbols[i], result.data, dispatcher);
+        }
+
+        if (running) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(refreshInterval));
+        }
+    }
+
+    dispatcher.stop();
+
+    std::cout << "Alerts stopped. " << engine.firedCount() << " alert(s) fired";
+    if (dispatcher.droppedCount() > 0) {
+        std::cout << ", " << dispatcher.droppedCount() << " deliveries dropped by a full queue";
+    }
+    if (dispatcher.discardedCount() > 0) {
+        std::cout << ", " << dispatcher.discardedCount() << " deliveries discarded at shutdown";
+    }
+    std::cout << ".\n" << std::endl;
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    auto processStart = std::chrono::steady_clock::now();
     std::string symbol = "";
     std::string exchange = "NASDAQ";
     bool watchMode = false;
     double refreshInterval = 0.7;
+    bool backfillMode = false;
+    std::string fromDate = "";
+    std::string toDate = "";
+    quote::BackfillOptions backfill;
+    int jobs = 4;
+    std::string alertsFile = "";
+    std::string alertLog = "";
+    std::vector<std::string> alertHooks;
+    bool gridMode = false;
+    std::string watchlistFile = "";
+    double frameBudgetMs = 15.0;
+    std::string portfolioFile = "";
+    std::string baseCurrency = "USD";
+    double fxRefreshSeconds = 300.0;
+    bool showTiming = false;
+    bool useState = true;
 
     signal(SIGINT, signalHandler);
     for (int i = 1; i < argc; i++) {
@@ -38,61 +323,175 @@ int main(int argc, char* argv[]) {
                 refreshInterval = std::stod(argv[++i]);
                 if (refreshInterval < 0.1) refreshInterval = 0.1;
             }
+        } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--backfill") == 0) {
+            backfillMode = true;
+        } else if (strcmp(argv[i], "--from") == 0) {
+            if (i + 1 < argc) {
+                fromDate = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--to") == 0) {
+            if (i + 1 < argc) {
+                toDate = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--bar") == 0) {
+            if (i + 1 < argc) {
+                backfill.interval = argv[++i];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
+            if (i + 1 < argc) {
+                backfill.outputDir = argv[++i];
+            }
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+            if (i + 1 < argc) {
+                jobs = std::max(1, std::atoi(argv[++i]));
+            }
+        } else if (strcmp(argv[i], "--rate") == 0) {
+            if (i + 1 < argc) {
+                backfill.requestsPerSecond = std::stod(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--grid") == 0) {
+            gridMode = true;
+        } else if (strcmp(argv[i], "--watchlist") == 0) {
+            if (i + 1 < argc) {
+                watchlistFile = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--frame-budget") == 0) {
+            if (i + 1 < argc) {
+                frameBudgetMs = std::stod(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--portfolio") == 0) {
+            if (i + 1 < argc) {
+                portfolioFile = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--base") == 0) {
+            if (i + 1 < argc) {
+                baseCurrency = argv[++i];
+                std::transform(baseCurrency.begin(), baseCurrency.end(), baseCurrency.begin(), ::toupper);
+            }
+        } else if (strcmp(argv[i], "--fx-refresh") == 0) {
+            if (i + 1 < argc) {
+                fxRefreshSeconds = std::stod(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--alerts") == 0) {
+            if (i + 1 < argc) {
+                alertsFile = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--alert-log") == 0) {
+            if (i + 1 < argc) {
+                alertLog = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--alert-exec") == 0) {
+            if (i + 1 < argc) {
+                alertHooks.push_back(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--timing") == 0) {
+            showTiming = true;
+        } else if (strcmp(argv[i], "--no-state") == 0) {
+            useState = false;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            std::cout << "Usage: " << argv[0] << " [options]\n"
-                      << "Options:\n"
-                      << "  -s, --symbol SYMBOL      Specify the stock symbol (required)\n"
-                      << "  -e, --exchange EXCHANGE  Specify the exchange suffix (default: none for US stocks)\n"
-                      << "                           Examples: TO (TSX), L (LSE), DE (XETRA),\n"
-                      << "                           PA (Euronext), AX (ASX), HK (Hong Kong), NS (NSE)\n"
-                      << "  -w, --watch              Enable continuous monitoring mode\n"
-                      << "  -i, --interval SECONDS   Refresh interval for watch mode (default: 2.0 seconds, min: 0.1)\n"
-                      << "  -h, --help               Show this help message\n"
-                      << "\nExamples:\n"
-                      << "  " << argv[0] << " -s TSLA           # Single quote fetch (US stock)\n"
-                      << "  " << argv[0] << " -s SHOP -e TO     # Toronto Stock Exchange\n"
-                      << "  " << argv[0] << " -s VOD -e L       # London Stock Exchange\n"
-                      << "  " << argv[0] << " -s AAPL -w        # Watch mode with 2.0s real-time updates\n"
-                      << "  " << argv[0] << " -s MSFT -w -i 0.1 # Ultra-fast 100ms updates\n"
-                      << "  " << argv[0] << " -s TSLA -w -i 5   # Watch mode with 5s intervals\n";
+            printUsage(argv[0], true);
             return 0;
         }
     }
 
+    quote::ClientOptions clientOptions;
+    clientOptions.maxConnections = jobs;
+    if (useState) {
+        clientOptions.statePath = defaultStatePath();
+    }
+
+    if (!alertsFile.empty()) {
+        return runAlerts(alertsFile, alertLog, alertHooks, exchange, refreshInterval, clientOptions);
+    }
+
+    if (!portfolioFile.empty()) {
+        return runPortfolio(portfolioFile, exchange, baseCurrency, fxRefreshSeconds, watchMode, refreshInterval, clientOptions);
+    }
+
+    if (gridMode) {
+        std::vector<std::string> symbols;
+        if (!parseSymbolList(symbol, symbols) ||
+            (!watchlistFile.empty() && !readWatchlist(watchlistFile, symbols))) {
+            return 1;
+        }
+        if (symbols.empty()) {
+            printUsage(argv[0], false);
+            return 1;
+        }
+        return runGrid(symbols, exchange, refreshInterval, clientOptions, frameBudgetMs);
+    }
+
     if (symbol.empty()) {
-        std::cout << "Usage: " << argv[0] << " [options]\n"
-                  << "Options:\n"
-                  << "  -s, --symbol SYMBOL      Specify the stock symbol (required)\n"
-                  << "  -e, --exchange EXCHANGE  Specify the exchange suffix (default: none for US stocks)\n"
-                  << "                           Examples: TO (TSX), L (LSE), DE (XETRA),\n"
-                  << "                           PA (Euronext), AX (ASX), HK (Hong Kong), NS (NSE)\n"
-                  << "  -w, --watch              Enable continuous monitoring mode\n"
-                  << "  -i, --interval SECONDS   Refresh interval for watch mode (default: 2.0 seconds, min: 0.1)\n"
-                  << "  -h, --help               Show this help message\n";
+        printUsage(argv[0], false);
         return 1;
     }
+
+    if (backfillMode) {
+        if (!parseSymbolList(symbol, backfill.symbols)) {
+            return 1;
+        }
+
+        backfill.exchange = exchange;
+        backfill.jobs = jobs;
+        backfill.statePath = clientOptions.statePath;
+        backfill.from = quote::Backfill::parseDate(fromDate);
+        backfill.to = toDate.empty() ? 0 : quote::Backfill::parseDate(toDate);
+        if (fromDate.empty() || backfill.from < 0 || backfill.to < 0) {
+            std::cerr << "Error: Backfill needs --from YYYY-MM-DD (and optionally --to YYYY-MM-DD)" << std::endl;
+            return 1;
+        }
+        if (backfill.to > 0) {
+            backfill.to += 86400; // --to includes its whole day
+        }
+
+        quote::Backfill job(backfill, &running);
+        return job.run() ? 0 : 1;
+    }
     
     
-    quote::Quote q(symbol, exchange);
+    quote::Client client(clientOptions);
+    quote::Quote q(symbol, exchange, client);
     
     if (watchMode) {
         std::cout << "\033[?25l" << std::flush;
 
+        int lastUpdatedRow = 0;
+        // Errors go into the frame; anything written to stderr would be cleared with the screen
+        std::ostringstream errors;
+        q.reportErrorsTo(errors);
+
         while (running) {
-            system("tput clear 2>/dev/null || clear 2>/dev/null || printf '\\033[2J\\033[H'");
-            std::cout << "\033[2J\033[H" << std::flush;
+            errors.str("");
+            bool fetched = q.fetchQuoteData(symbol);
 
-            auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-            std::cout << "Every " << refreshInterval << "s: quote -s " << symbol;
-            if (exchange != "NASDAQ") std::cout << " -e " << exchange;
-            std::cout << "    " << std::put_time(std::localtime(&time_t), "%a %b %d %H:%M:%S %Y") << "\n";
+            if (fetched && !q.lastFetchChanged() && lastUpdatedRow > 0) {
+                // Nothing new: rewrite the "Last Updated" row in place and leave the rest alone
+                std::cout << "\033[" << lastUpdatedRow << ";1H\033[2K";
+                q.displayLastUpdated(std::cout);
+                std::cout << std::flush;
+            } else {
+                auto now = std::chrono::system_clock::now();
+                auto time_t = std::chrono::system_clock::to_time_t(now);
+                std::ostringstream frame;
+                frame << "Every " << refreshInterval << "s: quote -s " << symbol;
+                if (exchange != "NASDAQ") frame << " -e " << exchange;
+                frame << "    " << std::put_time(std::localtime(&time_t), "%a %b %d %H:%M:%S %Y") << "\n";
 
-            if (q.fetchQuoteData(symbol)) {
-                q.displayStockInfo();
-            }
+                if (fetched) {
+                    q.displayStockInfo(frame);
+                } else {
+                    frame << "\n" << errors.str();
+                }
 
-            std::cout << std::flush;
+                std::string text = frame.str();
+                size_t pos = text.find("Last Updated: ");
+                lastUpdatedRow = (pos == std::string::npos) ? 0 : 1 + std::count(text.begin(), text.begin() + pos, '\n');
+                // The row count assumes no line wraps; the dashboard's rules are 80 columns wide
+                int columns = terminalColumns();
+                if (columns > 0 && columns < 80) lastUpdatedRow = 0;
+
+                std::cout << "\033[2J\033[H" << text << std::flush;
+            }
 
             if (running) {
                 std::this_thread::sleep_for(std::chrono::duration<double>(refreshInterval));
@@ -100,7 +499,8 @@ int main(int argc, char* argv[]) {
         }
 
         std::cout << "\033[?25h" << std::flush;
-        std::cout << "\nMonitoring stopped.\n" << std::endl;
+        std::cout << "\nMonitoring stopped. Skipped " << q.skippedTicks()
+                  << " unchanged update(s).\n" << std::endl;
     } else {
         std::cout << "Fetching quote for " << symbol;
         if (!exchange.empty()) {
@@ -109,6 +509,9 @@ int main(int argc, char* argv[]) {
         std::cout << std::endl;
 
         q.fetchQuote(symbol);
+        if (showTiming) {
+            printTiming(q.lastTiming(), q.getStockData().hasData, processStart);
+        }
 
         std::cout << "Quote operation completed." << std::endl;
     }
@@ -1,5 +1,6 @@
+#pragma once
+#include "libquote.h"
 #include<iostream>
-#include<curl/curl.h>
 #include<string>
 #include<vector>
 #include<sstream>
@@ -7,372 +8,21 @@
 #include<algorithm>
 #include<cmath>
 #include<chrono>
+#include<cstdint>
 
 namespace quote {
-// Stock data structure
-struct StockData {
-    std::string symbol;
-    std::string name;
-    std::string currency;
-    std::string exchange;
-    double currentPrice = 0.0;
-    double previousClose = 0.0;
-    double dayHigh = 0.0;
-    double dayLow = 0.0;
-    double fiftyTwoWeekHigh = 0.0;
-    double fiftyTwoWeekLow = 0.0;
-    long volume = 0;
-    std::vector<double> prices;
-    std::vector<long> timestamps;
-    bool hasData = false;
-    std::string lastFetchTime = "";
-    double fetchDurationMs = 0.0;
-};
-
-// A simple class for a command-line tool that fetches stock quotes from Google Finance
+// A simple class for a command-line tool that fetches and displays stock quotes through Client
 class Quote {
 private:
     std::string symbol;   // Stock symbol (e.g., "GOOGL")
     std::string exchange; // Exchange name (e.g., "NYSE")
-    std::string fetchedData; // Store the raw fetched data
+    Client* client;       // Transfer engine shared with other Quote instances
     StockData stockData; // Parsed stock data
-
-    // Static callback function for curl
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
-        return size * nmemb;
-    }
-
-    // Private method to fetch data from Google Finance
-    std::string fetchDataFromGoogleFinance(const std::string& symbol, const std::string& exchange) {
-        // We'll use libcurl to make HTTP requests
-        CURL* curl;
-        CURLcode res;
-        std::string readBuffer;
-
-        // Initialize curl
-        curl = curl_easy_init();
-        if (curl) {
-            // Let user specify the full symbol with exchange suffix
-            // If exchange is provided and doesn't start with a dot, add it
-            std::string fullSymbol = symbol;
-            if (!exchange.empty() && exchange != "NASDAQ" && exchange != "NYSE") {
-                if (exchange[0] != '.') {
-                    fullSymbol += "." + exchange;
-                } else {
-                    fullSymbol += exchange;
-                }
-            }
-            
-            const std::string url = "https://query1.finance.yahoo.com/v8/finance/chart/" + fullSymbol;
-            
-            // Set URL to fetch
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            
-            // Set callback function to receive data
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-            
-            // Set data buffer to write to
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-            
-            // Set user agent to avoid being blocked
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36");
-            
-            // Follow redirects
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-            
-            // Set timeout
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-            
-            // Perform the request
-            res = curl_easy_perform(curl);
-            
-            // Get HTTP response code
-            long response_code;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-            
-            // Check for errors
-            if (res != CURLE_OK) {
-                handleError("curl_easy_perform() failed: " + std::string(curl_easy_strerror(res)));
-                curl_easy_cleanup(curl);
-                return "";
-            }
-            
-            if (response_code != 200) {
-                handleError("HTTP request failed with response code: " + std::to_string(response_code));
-            }
-            
-            // Clean up
-            curl_easy_cleanup(curl);
-            
-            return readBuffer;
-        } else {
-            handleError("Failed to initialize curl");
-            return "";
-        }
-    }
-
-
-    // Private method to parse the fetched data
-    void parseData(const std::string& data) {
-        // Check if the response contains valid data
-        if (data.find("\"result\":null") != std::string::npos || 
-            data.find("\"result\":[]") != std::string::npos) {
-            fetchedData = "No data found for this symbol/exchange combination.";
-            return;
-        }
-        
-        // More specific error checking - look for actual error structure
-        if (data.find("\"chart\":{\"error\"") != std::string::npos) {
-            fetchedData = "API returned an error.";
-            return;
-        }
-
-        // Parse JSON response
-        parseStockData(data);
-        fetchedData = data; // Keep raw data for debugging
-    }
-
-    // Parse JSON and extract stock data
-    void parseStockData(const std::string& jsonData) {
-        // Save timing info before resetting stockData
-        std::string savedFetchTime = stockData.lastFetchTime;
-        double savedFetchDuration = stockData.fetchDurationMs;
-        
-        stockData = StockData();
-        
-        // Restore timing info
-        stockData.lastFetchTime = savedFetchTime;
-        stockData.fetchDurationMs = savedFetchDuration;
-        
-        try {
-            // Check if we have valid result data
-            if (jsonData.find("\"result\":null") != std::string::npos) {
-                return;
-            }
-            
-            // Extract meta information from the first result
-            size_t metaPos = jsonData.find("\"meta\":");
-            if (metaPos == std::string::npos) {
-                return;
-            }
-            
-            // Extract from meta section
-            stockData.symbol = extractStringFromMeta(jsonData, "symbol");
-            stockData.name = extractStringFromMeta(jsonData, "longName");
-            if (stockData.name.empty()) {
-                stockData.name = extractStringFromMeta(jsonData, "shortName");
-            }
-            stockData.currency = extractStringFromMeta(jsonData, "currency");
-            stockData.exchange = extractStringFromMeta(jsonData, "exchangeName");
-            
-            // Extract price data from meta section
-            stockData.currentPrice = extractDoubleFromMeta(jsonData, "regularMarketPrice");
-            stockData.previousClose = extractDoubleFromMeta(jsonData, "previousClose");
-            stockData.dayHigh = extractDoubleFromMeta(jsonData, "regularMarketDayHigh");
-            stockData.dayLow = extractDoubleFromMeta(jsonData, "regularMarketDayLow");
-            stockData.fiftyTwoWeekHigh = extractDoubleFromMeta(jsonData, "fiftyTwoWeekHigh");
-            stockData.fiftyTwoWeekLow = extractDoubleFromMeta(jsonData, "fiftyTwoWeekLow");
-            stockData.volume = extractLongFromMeta(jsonData, "regularMarketVolume");
-            
-            // If regularMarketPrice is 0, try chartPreviousClose as current price
-            if (stockData.currentPrice == 0.0) {
-                stockData.currentPrice = extractDoubleFromMeta(jsonData, "chartPreviousClose");
-            }
-            
-            // Extract price array for graph from indicators.quote[0].close
-            extractPriceArrayFromIndicators(jsonData, stockData.prices, stockData.timestamps);
-            
-            stockData.hasData = (stockData.currentPrice > 0);
-            
-        } catch (const std::exception& e) {
-            stockData.hasData = false;
-        } catch (...) {
-            stockData.hasData = false;
-        }
-    }
-
-    // Helper function to extract string values from meta section
-    std::string extractStringFromMeta(const std::string& json, const std::string& key) {
-        size_t metaPos = json.find("\"meta\":");
-        if (metaPos == std::string::npos) return "";
-        
-        size_t metaEnd = json.find("\"timestamp\":", metaPos);
-        if (metaEnd == std::string::npos) metaEnd = json.size();
-        
-        std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
-        
-        std::string searchKey = "\"" + key + "\":\"";
-        size_t pos = metaSection.find(searchKey);
-        if (pos != std::string::npos) {
-            pos += searchKey.length();
-            size_t end = metaSection.find("\"", pos);
-            if (end != std::string::npos) {
-                return metaSection.substr(pos, end - pos);
-            }
-        }
-        return "";
-    }
-
-    // Helper function to extract double values from meta section
-    double extractDoubleFromMeta(const std::string& json, const std::string& key) {
-        size_t metaPos = json.find("\"meta\":");
-        if (metaPos == std::string::npos) return 0.0;
-        
-        size_t metaEnd = json.find("\"timestamp\":", metaPos);
-        if (metaEnd == std::string::npos) metaEnd = json.size();
-        
-        std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
-        
-        std::string searchKey = "\"" + key + "\":";
-        size_t pos = metaSection.find(searchKey);
-        if (pos != std::string::npos) {
-            pos += searchKey.length();
-            size_t end = metaSection.find_first_of(",}", pos);
-            if (end != std::string::npos) {
-                std::string valueStr = metaSection.substr(pos, end - pos);
-                try {
-                    return std::stod(valueStr);
-                } catch (...) {
-                    return 0.0;
-                }
-            }
-        }
-        return 0.0;
-    }
-
-    // Helper function to extract long values from meta section
-    long extractLongFromMeta(const std::string& json, const std::string& key) {
-        size_t metaPos = json.find("\"meta\":");
-        if (metaPos == std::string::npos) return 0;
-        
-        size_t metaEnd = json.find("\"timestamp\":", metaPos);
-        if (metaEnd == std::string::npos) metaEnd = json.size();
-        
-        std::string metaSection = json.substr(metaPos, metaEnd - metaPos);
-        
-        std::string searchKey = "\"" + key + "\":";
-        size_t pos = metaSection.find(searchKey);
-        if (pos != std::string::npos) {
-            pos += searchKey.length();
-            size_t end = metaSection.find_first_of(",}", pos);
-            if (end != std::string::npos) {
-                std::string valueStr = metaSection.substr(pos, end - pos);
-                try {
-                    return std::stol(valueStr);
-                } catch (...) {
-                    return 0;
-                }
-            }
-        }
-        return 0;
-    }
-
-    // Helper functions for JSON parsing
-    void extractValue(const std::string& json, const std::string& key, std::string& value) {
-        size_t pos = json.find(key);
-        if (pos != std::string::npos) {
-            pos += key.length();
-            size_t end = json.find("\"", pos);
-            if (end != std::string::npos) {
-                value = json.substr(pos, end - pos);
-            }
-        }
-    }
-
-    double extractDoubleValue(const std::string& json, const std::string& key) {
-        size_t pos = json.find(key);
-        if (pos != std::string::npos) {
-            pos += key.length();
-            size_t end = json.find_first_of(",}", pos);
-            if (end != std::string::npos) {
-                std::string valueStr = json.substr(pos, end - pos);
-                return std::stod(valueStr);
-            }
-        }
-        return 0.0;
-    }
-
-    long extractLongValue(const std::string& json, const std::string& key) {
-        size_t pos = json.find(key);
-        if (pos != std::string::npos) {
-            pos += key.length();
-            size_t end = json.find_first_of(",}", pos);
-            if (end != std::string::npos) {
-                std::string valueStr = json.substr(pos, end - pos);
-                return std::stol(valueStr);
-            }
-        }
-        return 0;
-    }
-
-    void extractPriceArrayFromIndicators(const std::string& json, std::vector<double>& prices, std::vector<long>& timestamps) {
-        // First extract timestamps from the main data section
-        size_t timestampPos = json.find("\"timestamp\":[");
-        if (timestampPos != std::string::npos) {
-            timestampPos += 13; // length of "\"timestamp\":["
-            size_t endPos = json.find("]", timestampPos);
-            if (endPos != std::string::npos) {
-                std::string timestampStr = json.substr(timestampPos, endPos - timestampPos);
-                std::stringstream ss(timestampStr);
-                std::string timestamp;
-                
-                while (std::getline(ss, timestamp, ',')) {
-                    try {
-                        // Remove any whitespace
-                        timestamp.erase(0, timestamp.find_first_not_of(" \t\n\r"));
-                        timestamp.erase(timestamp.find_last_not_of(" \t\n\r") + 1);
-                        
-                        if (!timestamp.empty() && timestamp != "null") {
-                            timestamps.push_back(std::stol(timestamp));
-                        }
-                    } catch (...) {
-                        // Skip invalid values
-                    }
-                }
-            }
-        }
-        
-        // Look for the indicators section with quote data
-        size_t indicatorsPos = json.find("\"indicators\":");
-        if (indicatorsPos == std::string::npos) return;
-        
-        size_t quotePos = json.find("\"quote\":[", indicatorsPos);
-        if (quotePos == std::string::npos) return;
-        
-        size_t closePos = json.find("\"close\":[", quotePos);
-        if (closePos != std::string::npos) {
-            closePos += 9; // length of "\"close\":["
-            size_t endPos = json.find("]", closePos);
-            if (endPos != std::string::npos) {
-                std::string priceStr = json.substr(closePos, endPos - closePos);
-                std::stringstream ss(priceStr);
-                std::string price;
-                
-                while (std::getline(ss, price, ',')) {
-                    try {
-                        // Remove any whitespace
-                        price.erase(0, price.find_first_not_of(" \t\n\r"));
-                        price.erase(price.find_last_not_of(" \t\n\r") + 1);
-                        
-                        if (!price.empty() && price != "null") {
-                            prices.push_back(std::stod(price));
-                        }
-                    } catch (...) {
-                        // Skip invalid values - keep arrays aligned
-                        if (!timestamps.empty() && timestamps.size() > prices.size()) {
-                            timestamps.pop_back();
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Ensure arrays are the same size - trim timestamps if needed
-        while (timestamps.size() > prices.size() && !timestamps.empty()) {
-            timestamps.pop_back();
-        }
-    }
+    uint64_t lastFingerprint = 0; // Hash of the last parsed response body
+    bool lastChanged = true;      // Whether the last fetch carried new data
+    long unchangedTicks = 0;      // Fetches skipped because nothing changed
+    Timing timing;                // Phase breakdown of the last fetch
+    std::ostream* errorOut = &std::cerr; // Where fetch errors are reported
 
     // Generate ASCII graph
     std::string generateGraph(const std::vector<double>& prices, int width = 60, int height = 10) const {
@@ -526,17 +176,7 @@ private:
 
     // Private method to handle errors
     void handleError(const std::string& errorMessage) {
-        std::cerr << "Error: " << errorMessage << std::endl;
-    }
-    
-    // Private method to validate the stock symbol
-    bool isValidSymbol(const std::string& symbol) const {
-        // Basic validation - not empty and contains only alphanumeric characters
-        if (symbol.empty()) return false;
-        for (char c : symbol) {
-            if (!std::isalnum(c) && c != '.') return false;
-        }
-        return true;
+        *errorOut << "Error: " << errorMessage << std::endl;
     }
     
     // Private method to validate the exchange name
@@ -547,9 +187,10 @@ private:
 
 public:
     // Creates a new Quote instance
-    Quote(std::string symbol = "", std::string exchange = "NYSE") {
+    Quote(std::string symbol = "", std::string exchange = "NYSE", Client& client = Client::shared()) {
         this->symbol = symbol;
         this->exchange = exchange;
+        this->client = &client;
     };
 
     // Cleans up resources
@@ -561,37 +202,53 @@ public:
     // Fetch quote data without displaying (for watch mode)
     bool fetchQuoteData(const std::string& symbol)
     {
-        // Start timing
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        if (!isValidSymbol(symbol)) {
-            handleError("Invalid stock symbol: " + symbol);
+        this->symbol = symbol;
+
+        QuoteResult result = client->fetchQuote(symbol, exchange, stockData.hasData ? lastFingerprint : 0).get();
+        timing = result.timing;
+        if (result.error) {
+            handleError(result.error.message);
+            if (result.error.code == ErrorCode::Network) {
+                handleError("Failed to fetch data for symbol: " + symbol + " on exchange: " + exchange);
+            }
             return false;
         }
-        
-        this->symbol = symbol;
-        
-        std::string data = fetchDataFromGoogleFinance(symbol, exchange);
-        
-        // End timing
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        stockData.fetchDurationMs = duration.count() / 1000.0; // Convert to milliseconds
-        
-        // Set timestamp
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        stockData.lastFetchTime = ss.str();
-        
-        if (!data.empty()) {
-            parseData(data);
-            return true;
+
+        lastChanged = !result.unchanged;
+        if (result.unchanged) {
+            unchangedTicks++;
+            stockData.lastFetchTime = result.data.lastFetchTime;
+            stockData.fetchDurationMs = result.data.fetchDurationMs;
         } else {
-            handleError("Failed to fetch data for symbol: " + symbol + " on exchange: " + exchange);
-            return false;
+            stockData = std::move(result.data);
+            lastFingerprint = result.fingerprint;
         }
+        return true;
+    }
+
+    // True if the last successful fetch returned different data than the one before
+    bool lastFetchChanged() const {
+        return lastChanged;
+    }
+
+    // Parsed data from the last successful fetch
+    const StockData& getStockData() const {
+        return stockData;
+    }
+
+    // Number of fetches this session that returned unchanged data
+    long skippedTicks() const {
+        return unchangedTicks;
+    }
+
+    // Sends fetch errors to out instead of stderr, e.g. to render them into a frame
+    void reportErrorsTo(std::ostream& out) {
+        errorOut = &out;
+    }
+
+    // Where the time of the last fetch went
+    const Timing& lastTiming() const {
+        return timing;
     }
 
     void fetchQuote(const std::string& symbol)
@@ -602,9 +259,9 @@ public:
     }
 
     // Public method to display stock information
-    void displayStockInfo() const {
+    void displayStockInfo(std::ostream& out = std::cout) const {
         if (!stockData.hasData) {
-            std::cout << "No valid stock data available." << std::endl;
+            out << "No valid stock data available." << std::endl;
             return;
         }
 
@@ -624,59 +281,68 @@ public:
         std::string changeSymbol = (change >= 0) ? "▲" : "▼";
         
         // Header
-        std::cout << "\n" << std::string(80, '=') << std::endl;
-        std::cout << bold << "  STOCK QUOTE DASHBOARD" << reset << std::endl;
-        std::cout << std::string(80, '=') << std::endl;
+        out << "\n" << std::string(80, '=') << std::endl;
+        out << bold << "  STOCK QUOTE DASHBOARD" << reset << std::endl;
+        out << std::string(80, '=') << std::endl;
         
         // Stock info
-        std::cout << bold << blue << stockData.symbol << reset;
+        out << bold << blue << stockData.symbol << reset;
         if (!stockData.name.empty()) {
-            std::cout << " - " << stockData.name;
+            out << " - " << stockData.name;
         }
-        std::cout << " (" << stockData.exchange << ")" << std::endl;
+        out << " (" << stockData.exchange << ")" << std::endl;
         
         // Current price and change
-        std::cout << "\n" << bold << "Current Price: " << reset 
-                  << yellow << std::fixed << std::setprecision(2) 
-                  << stockData.currentPrice << " " << stockData.currency << reset;
+        out << "\n" << bold << "Current Price: " << reset 
+            << yellow << std::fixed << std::setprecision(2) 
+            << stockData.currentPrice << " " << stockData.currency << reset;
         
-        std::cout << "  " << changeColor << changeSymbol << " " 
-                  << std::abs(change) << " (" 
-                  << std::showpos << std::setprecision(2) << changePercent 
-                  << "%)" << std::noshowpos << reset << std::endl;
+        out << "  " << changeColor << changeSymbol << " " 
+            << std::abs(change) << " (" 
+            << std::showpos << std::setprecision(2) << changePercent 
+            << "%)" << std::noshowpos << reset << std::endl;
         
         // Price ranges
-        std::cout << "\n" << bold << "Day Range:    " << reset 
-                  << stockData.dayLow << " - " << stockData.dayHigh << " " << stockData.currency << std::endl;
+        out << "\n" << bold << "Day Range:    " << reset 
+            << stockData.dayLow << " - " << stockData.dayHigh << " " << stockData.currency << std::endl;
         
-        std::cout << bold << "52W Range:    " << reset 
-                  << stockData.fiftyTwoWeekLow << " - " << stockData.fiftyTwoWeekHigh 
-                  << " " << stockData.currency << std::endl;
+        out << bold << "52W Range:    " << reset 
+            << stockData.fiftyTwoWeekLow << " - " << stockData.fiftyTwoWeekHigh 
+            << " " << stockData.currency << std::endl;
         
-        std::cout << bold << "Volume:       " << reset << stockData.volume << std::endl;
-        std::cout << bold << "Prev Close:   " << reset << stockData.previousClose 
-                  << " " << stockData.currency << std::endl;
+        out << bold << "Volume:       " << reset << stockData.volume << std::endl;
+        out << bold << "Prev Close:   " << reset << stockData.previousClose 
+            << " " << stockData.currency << std::endl;
         
         // Fetch information
         if (!stockData.lastFetchTime.empty()) {
-            std::cout << "\n" << bold << "Last Updated: " << reset << stockData.lastFetchTime;
-            if (stockData.fetchDurationMs > 0) {
-                std::cout << " (" << std::fixed << std::setprecision(1) 
-                          << stockData.fetchDurationMs << "ms)";
-            }
-            std::cout << std::endl;
+            out << "\n";
+            displayLastUpdated(out);
+            out << std::endl;
         }
         
         // Price graph
         if (!stockData.prices.empty()) {
-            std::cout << "\n" << bold << "Intraday Price Chart:" << reset << std::endl;
-            std::cout << generateGraph(stockData.prices) << std::endl;
+            out << "\n" << bold << "Intraday Price Chart:" << reset << std::endl;
+            out << generateGraph(stockData.prices) << std::endl;
+        }
+    }
+
+    // Writes the "Last Updated" line on its own so watch mode can refresh just that row
+    void displayLastUpdated(std::ostream& out = std::cout) const {
+        std::string reset = "\033[0m";
+        std::string bold = "\033[1m";
+
+        out << bold << "Last Updated: " << reset << stockData.lastFetchTime;
+        if (stockData.fetchDurationMs > 0) {
+            out << " (" << std::fixed << std::setprecision(1)
+                << stockData.fetchDurationMs << "ms)";
         }
     }
 
     // Shows the retrieved stock information
     void displayQuote() {
-        if (!fetchedData.empty()) {
+        if (!stockData.lastFetchTime.empty()) {
             displayStockInfo();
         } else {
             std::cout << "No quote data available. Please fetch a quote first." << std::endl;